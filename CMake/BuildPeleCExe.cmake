@@ -70,23 +70,36 @@ function(build_pelec_exe pelec_exe_name pelec_lib_name)
 
   target_sources(${pelec_exe_name}
      PRIVATE
+       ${SRC_DIR}/ActiveSpecies.H
+       ${SRC_DIR}/ActiveSpecies.cpp
        ${SRC_DIR}/Advance.cpp
        ${SRC_DIR}/BCfill.cpp
+       ${SRC_DIR}/BlockReader.H
+       ${SRC_DIR}/BlockReader.cpp
        ${SRC_DIR}/Bld.cpp
        ${SRC_DIR}/Constants.H
        ${SRC_DIR}/Derive.H
        ${SRC_DIR}/Derive.cpp
+       ${SRC_DIR}/DeltaCheckpoint.H
+       ${SRC_DIR}/DeltaCheckpoint.cpp
        ${SRC_DIR}/Diffterm.H
        ${SRC_DIR}/Diffterm.cpp
        ${SRC_DIR}/Diffusion.H
        ${SRC_DIR}/Diffusion.cpp
+       ${SRC_DIR}/DiagProfile.H
+       ${SRC_DIR}/DiagProfile.cpp
+       ${SRC_DIR}/DiagSampler.H
+       ${SRC_DIR}/DiagSampler.cpp
        ${SRC_DIR}/EB.H
        ${SRC_DIR}/EB.cpp
        ${SRC_DIR}/EBStencilTypes.H
+       ${SRC_DIR}/EntropyProd.H
        ${SRC_DIR}/External.cpp
        ${SRC_DIR}/Filter.H
        ${SRC_DIR}/Filter.cpp
        ${SRC_DIR}/Forcing.cpp
+       ${SRC_DIR}/GradCache.H
+       ${SRC_DIR}/GradCache.cpp
        ${SRC_DIR}/GradUtil.H
        ${SRC_DIR}/GradUtil.cpp
        ${SRC_DIR}/Hydro.H
@@ -104,22 +117,34 @@ function(build_pelec_exe pelec_exe_name pelec_lib_name)
        ${SRC_DIR}/IO.cpp
        ${SRC_DIR}/LES.H
        ${SRC_DIR}/LES.cpp
+       ${SRC_DIR}/MixedPrecision.H
+       ${SRC_DIR}/MixedPrecision.cpp
        ${SRC_DIR}/MOL.H
        ${SRC_DIR}/MOL.cpp
        ${SRC_DIR}/PeleC.H
        ${SRC_DIR}/PeleC.cpp
        ${SRC_DIR}/PeleCAmr.H
        ${SRC_DIR}/PeleCAmr.cpp
+       ${SRC_DIR}/PerfCounters.H
+       ${SRC_DIR}/PerfCounters.cpp
+       ${SRC_DIR}/PltCompress.H
+       ${SRC_DIR}/PltCompress.cpp
+       ${SRC_DIR}/ProfileTable.H
+       ${SRC_DIR}/ProfileTable.cpp
        ${SRC_DIR}/ProblemDerive.H
        ${SRC_DIR}/React.cpp
        ${SRC_DIR}/Riemann.H
        ${SRC_DIR}/Setup.cpp
        ${SRC_DIR}/Sources.cpp
        ${SRC_DIR}/SparseData.H
+       ${SRC_DIR}/Stats.H
+       ${SRC_DIR}/Stats.cpp
        ${SRC_DIR}/SumIQ.cpp
        ${SRC_DIR}/SumUtils.cpp
        ${SRC_DIR}/Tagging.H
        ${SRC_DIR}/Tagging.cpp
+       ${SRC_DIR}/ThermoTable.H
+       ${SRC_DIR}/ThermoTable.cpp
        ${SRC_DIR}/Timestep.H
        ${SRC_DIR}/Utilities.H
        ${SRC_DIR}/Utilities.cpp
@@ -143,7 +168,8 @@ function(build_pelec_exe pelec_exe_name pelec_lib_name)
     endif()
   endif()
 
-  if(NOT "${pelec_exe_name}" STREQUAL "PeleC-UnitTests")
+  if(NOT "${pelec_exe_name}" STREQUAL "PeleC-UnitTests" AND
+     NOT "${pelec_exe_name}" STREQUAL "PeleC-Benchmarks")
     target_sources(${pelec_exe_name}
        PRIVATE
          ${CMAKE_SOURCE_DIR}/Source/main.cpp
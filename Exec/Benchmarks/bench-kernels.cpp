@@ -0,0 +1,853 @@
+/** \file bench-kernels.cpp
+ *  Synthetic-box drivers for the PeleC compute kernels
+ */
+
+#include <AMReX_ParmParse.H>
+
+#include "PeleC.H"
+#include "IndexDefines.H"
+#include "Utilities.H"
+#include "Godunov.H"
+#include "PLM.H"
+#include "PPM.H"
+#include "WENO.H"
+#include "Diffterm.H"
+#include "GradUtil.H"
+#include "LES.H"
+#include "Filter.H"
+#include "ProfileTable.H"
+#include "GradCache.H"
+#include "EntropyProd.H"
+#include "ThermoTable.H"
+#include "Benchmark.H"
+
+namespace pelec_bench {
+
+namespace {
+
+constexpr amrex::Long rsize = sizeof(amrex::Real);
+constexpr int nqaux = NQAUX > 0 ? NQAUX : 1;
+
+// Face-centered area factors of a uniform Cartesian grid
+void
+fill_areas(
+  const BenchContext& ctx, amrex::FArrayBox (&area)[AMREX_SPACEDIM])
+{
+  const auto dx = ctx.geom.CellSizeArray();
+  for (int dir = 0; dir < AMREX_SPACEDIM; ++dir) {
+    amrex::Real a = 1.0;
+    for (int d = 0; d < AMREX_SPACEDIM; ++d) {
+      if (d != dir) {
+        a *= dx[d];
+      }
+    }
+    area[dir].resize(
+      amrex::surroundingNodes(ctx.bx, dir), 1, amrex::The_Async_Arena());
+    area[dir].setVal<amrex::RunOn::Device>(a);
+  }
+}
+
+// Tangential velocity derivatives on the faces of the valid box
+void
+fill_tangential_derivs(
+  const BenchContext& ctx, amrex::FArrayBox (&tander)[AMREX_SPACEDIM])
+{
+  const auto dx = ctx.geom.CellSizeArray();
+  const auto q = ctx.Q.const_array();
+  for (int dir = 0; dir < AMREX_SPACEDIM; ++dir) {
+    amrex::Real d1 = 0.0;
+    amrex::Real d2 = 0.0;
+    if (dir == 0) {
+      AMREX_D_TERM(d2 = 1.0;, d1 = dx[1];, d2 = dx[2];);
+    } else if (dir == 1) {
+      AMREX_D_TERM(d2 = 1.0;, d1 = dx[0];, d2 = dx[2];);
+    } else {
+      d1 = dx[0];
+      d2 = dx[1];
+    }
+    const amrex::Box ebox = amrex::surroundingNodes(ctx.bx, dir);
+    tander[dir].resize(ebox, GradUtils::nCompTan, amrex::The_Async_Arena());
+    auto const& td = tander[dir].array();
+    amrex::ParallelFor(
+      ebox, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
+        pc_compute_tangential_vel_derivs(i, j, k, q, dir, d1, d2, td);
+      });
+  }
+}
+
+amrex::Long
+num_faces(const amrex::Box& bx)
+{
+  amrex::Long nf = 0;
+  for (int dir = 0; dir < AMREX_SPACEDIM; ++dir) {
+    nf += amrex::surroundingNodes(bx, dir).numPts();
+  }
+  return nf;
+}
+
+BenchResult
+bench_ctoprim(const BenchContext& ctx)
+{
+  const amrex::Box gbx = amrex::grow(ctx.bx, ctx.ngrow);
+  amrex::FArrayBox q(gbx, QVAR, amrex::The_Async_Arena());
+  amrex::FArrayBox qaux(gbx, nqaux, amrex::The_Async_Arena());
+  const auto u = ctx.U.const_array();
+  const auto qarr = q.array();
+  const auto qaarr = qaux.array();
+
+  const amrex::Long cells = gbx.numPts();
+  return run_benchmark(
+    "ctoprim", ctx, cells, cells * (NVAR + QVAR + NQAUX) * rsize, [&]() {
+      amrex::ParallelFor(
+        gbx, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
+          pc_ctoprim(i, j, k, u, qarr, qaarr);
+        });
+    });
+}
+
+BenchResult
+bench_riemann(const BenchContext& ctx)
+{
+  // Left and right states on each face are the neighboring cell values
+  amrex::FArrayBox ql[AMREX_SPACEDIM];
+  amrex::FArrayBox qr[AMREX_SPACEDIM];
+  amrex::FArrayBox flux[AMREX_SPACEDIM];
+  amrex::FArrayBox qgdnv[AMREX_SPACEDIM];
+  const auto q = ctx.Q.const_array();
+  for (int dir = 0; dir < AMREX_SPACEDIM; ++dir) {
+    const amrex::Box ebox = amrex::surroundingNodes(ctx.bx, dir);
+    ql[dir].resize(ebox, QVAR, amrex::The_Async_Arena());
+    qr[dir].resize(ebox, QVAR, amrex::The_Async_Arena());
+    flux[dir].resize(ebox, NVAR, amrex::The_Async_Arena());
+    qgdnv[dir].resize(ebox, NGDNV, amrex::The_Async_Arena());
+    auto const& qlarr = ql[dir].array();
+    auto const& qrarr = qr[dir].array();
+    amrex::ParallelFor(
+      ebox, QVAR, [=] AMREX_GPU_DEVICE(int i, int j, int k, int n) noexcept {
+        const amrex::IntVect iv{AMREX_D_DECL(i, j, k)};
+        qlarr(iv, n) = q(iv - amrex::IntVect::TheDimensionVector(dir), n);
+        qrarr(iv, n) = q(iv, n);
+      });
+  }
+
+  const amrex::Box& domain = ctx.geom.Domain();
+  const auto qa = ctx.QA.const_array();
+  const amrex::Long cells = num_faces(ctx.bx);
+  return run_benchmark(
+    "riemann", ctx, cells, cells * (2 * QVAR + 2 + NVAR + NGDNV) * rsize,
+    [&]() {
+      for (int dir = 0; dir < AMREX_SPACEDIM; ++dir) {
+        const amrex::Box ebox = amrex::surroundingNodes(ctx.bx, dir);
+        const int domlo = domain.smallEnd(dir);
+        const int domhi = domain.bigEnd(dir);
+        auto const& qlarr = ql[dir].const_array();
+        auto const& qrarr = qr[dir].const_array();
+        auto const& flx = flux[dir].array();
+        auto const& qint = qgdnv[dir].array();
+        amrex::ParallelFor(
+          ebox, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
+            // bc = 0: interior faces, no outflow treatment
+            pc_cmpflx(
+              i, j, k, 0, 0, domlo, domhi, qlarr, qrarr, flx, qint, qa, dir);
+          });
+      }
+    });
+}
+
+struct PPMRecon
+{
+  static constexpr int halfwidth = 2;
+  AMREX_GPU_DEVICE AMREX_FORCE_INLINE void
+  operator()(const amrex::Real* s, amrex::Real& sm, amrex::Real& sp) const
+  {
+    ppm_reconstruct(s, 1.0, sm, sp);
+  }
+};
+
+struct WENO5Recon
+{
+  static constexpr int halfwidth = 2;
+  AMREX_GPU_DEVICE AMREX_FORCE_INLINE void
+  operator()(const amrex::Real* s, amrex::Real& sm, amrex::Real& sp) const
+  {
+    weno_reconstruct_5z(s, sm, sp);
+  }
+};
+
+struct WENO7Recon
+{
+  static constexpr int halfwidth = 3;
+  AMREX_GPU_DEVICE AMREX_FORCE_INLINE void
+  operator()(const amrex::Real* s, amrex::Real& sm, amrex::Real& sp) const
+  {
+    weno_reconstruct_7z(s, sm, sp);
+  }
+};
+
+// Edge values of every primitive variable in every direction
+template <typename Recon>
+BenchResult
+bench_reconstruction(const std::string& name, const BenchContext& ctx)
+{
+  constexpr int hw = Recon::halfwidth;
+  AMREX_ALWAYS_ASSERT(ctx.ngrow >= hw);
+  amrex::FArrayBox qm(ctx.bx, QVAR, amrex::The_Async_Arena());
+  amrex::FArrayBox qp(ctx.bx, QVAR, amrex::The_Async_Arena());
+  const auto q = ctx.Q.const_array();
+  auto const& qmarr = qm.array();
+  auto const& qparr = qp.array();
+  const amrex::Box bx = ctx.bx;
+
+  const amrex::Long cells = AMREX_SPACEDIM * bx.numPts();
+  return run_benchmark(name, ctx, cells, cells * 3 * QVAR * rsize, [&]() {
+    for (int dir = 0; dir < AMREX_SPACEDIM; ++dir) {
+      amrex::ParallelFor(
+        bx, QVAR, [=] AMREX_GPU_DEVICE(int i, int j, int k, int n) noexcept {
+          const amrex::IntVect iv{AMREX_D_DECL(i, j, k)};
+          const amrex::IntVect e = amrex::IntVect::TheDimensionVector(dir);
+          amrex::Real s[2 * hw + 1];
+          for (int m = 0; m < 2 * hw + 1; ++m) {
+            s[m] = q(iv + (m - hw) * e, n);
+          }
+          amrex::Real sm = 0.0;
+          amrex::Real sp = 0.0;
+          Recon()(s, sm, sp);
+          qmarr(iv, n) = sm;
+          qparr(iv, n) = sp;
+        });
+    }
+  });
+}
+
+BenchResult
+bench_plm(const BenchContext& ctx)
+{
+  const amrex::Box bx = ctx.bx;
+  amrex::FArrayBox qm(amrex::grow(bx, 1), QVAR, amrex::The_Async_Arena());
+  amrex::FArrayBox qp(amrex::grow(bx, 1), QVAR, amrex::The_Async_Arena());
+  const auto q = ctx.Q.const_array();
+  const auto qa = ctx.QA.const_array();
+  auto const& qmarr = qm.array();
+  auto const& qparr = qp.array();
+  const auto dx = ctx.geom.CellSizeArray();
+  const amrex::Real dt = ctx.dt;
+
+  const amrex::Long cells = AMREX_SPACEDIM * bx.numPts();
+  return run_benchmark(
+    "plm", ctx, cells, cells * (3 * QVAR + 1) * rsize, [&]() {
+      for (int dir = 0; dir < AMREX_SPACEDIM; ++dir) {
+        amrex::ParallelFor(
+          bx, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
+            amrex::Real slope[QVAR];
+            for (int n = 0; n < QVAR; ++n) {
+              slope[n] = plm_slope(AMREX_D_DECL(i, j, k), n, dir, q);
+            }
+            pc_plm_d(
+              AMREX_D_DECL(i, j, k), dir, qmarr, qparr, slope, q,
+              qa(i, j, k, QC), dx[dir], dt);
+          });
+      }
+    });
+}
+
+// Tables of the *_table kernels, or the polynomials (empty view). The
+// tables are cleared by the caller once the kernel is timed.
+pele::pelec::ThermoTableView
+thermo_view(const BenchContext& ctx, const bool table)
+{
+  pele::pelec::ThermoTable::clear();
+  if (table) {
+    pele::pelec::ThermoTable::build(
+      ctx.thermo_table_Tmin, ctx.thermo_table_Tmax, ctx.thermo_table_dT,
+      1.0e-4, false);
+  }
+  return pele::pelec::ThermoTable::view();
+}
+
+BenchResult
+bench_diffusion_flux(
+  const std::string& name, const BenchContext& ctx, const bool table)
+{
+  // Transport coefficients at cell centers, including one ghost cell
+  const amrex::Box cbx = amrex::grow(ctx.bx, 1);
+  amrex::FArrayBox coeff_cc(cbx, dComp_lambda + 1, amrex::The_Async_Arena());
+  {
+    auto const& qar_yin = ctx.Q.const_array(QFS);
+    auto const& qar_Tin = ctx.Q.const_array(QTEMP);
+    auto const& qar_rhoin = ctx.Q.const_array(QRHO);
+    auto const& coe_rhoD = coeff_cc.array(dComp_rhoD);
+    auto const& coe_mu = coeff_cc.array(dComp_mu);
+    auto const& coe_xi = coeff_cc.array(dComp_xi);
+    auto const& coe_lambda = coeff_cc.array(dComp_lambda);
+    auto const* ltransparm = PeleC::trans_parms.device_trans_parm();
+    amrex::launch(cbx, [=] AMREX_GPU_DEVICE(amrex::Box const& tbx) {
+      auto trans = pele::physics::PhysicsType::transport();
+      trans.get_transport_coeffs(
+        tbx, qar_yin, qar_Tin, qar_rhoin, coe_rhoD,
+        amrex::Array4<amrex::Real>(), coe_mu, coe_xi, coe_lambda, ltransparm);
+    });
+  }
+
+  amrex::FArrayBox tander[AMREX_SPACEDIM];
+  amrex::FArrayBox area[AMREX_SPACEDIM];
+  amrex::FArrayBox flux[AMREX_SPACEDIM];
+  fill_tangential_derivs(ctx, tander);
+  fill_areas(ctx, area);
+  for (int dir = 0; dir < AMREX_SPACEDIM; ++dir) {
+    flux[dir].resize(
+      amrex::surroundingNodes(ctx.bx, dir), NVAR, amrex::The_Async_Arena());
+    flux[dir].setVal<amrex::RunOn::Device>(0.0);
+  }
+
+  const auto q = ctx.Q.const_array();
+  const auto coef = coeff_cc.const_array();
+  const auto dx = ctx.geom.CellSizeArray();
+  const int do_harmonic = 1;
+  const auto thermo = thermo_view(ctx, table);
+  const auto spec = pele::pelec::SpeciesList::all();
+  amrex::FArrayBox xh_fab(cbx, nCompXH, amrex::The_Async_Arena());
+  auto const& xh = xh_fab.array();
+  const amrex::Long cells = num_faces(ctx.bx);
+  auto res = run_benchmark(
+    name, ctx, cells,
+    cells *
+      (2 * (QVAR + dComp_lambda + 1 + nCompXH) + GradUtils::nCompTan + 1 +
+       NVAR) *
+      rsize,
+    [&]() {
+      // Same per-cell pre-pass as pc_compute_diffusion_flux
+      amrex::ParallelFor(
+        cbx, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
+          pc_species_xh(i, j, k, q, thermo, xh);
+        });
+      for (int dir = 0; dir < AMREX_SPACEDIM; ++dir) {
+        const amrex::Box ebox = amrex::surroundingNodes(ctx.bx, dir);
+        auto const& td = tander[dir].const_array();
+        auto const& a = area[dir].const_array();
+        auto const& flx = flux[dir].array();
+        const amrex::Real delta = dx[dir];
+        amrex::ParallelFor(
+          ebox, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
+            amrex::GpuArray<amrex::Real, dComp_lambda + 1> cf = {0.0};
+            for (int n = 0; n < static_cast<int>(cf.size()); n++) {
+              pc_move_transcoefs_to_ec(
+                i, j, k, n, coef, cf.data(), dir, do_harmonic);
+            }
+            pc_diffusion_flux(
+              i, j, k, q, xh, cf, td, a, spec, flx, delta, dir);
+          });
+      }
+    });
+  pele::pelec::ThermoTable::clear();
+  return res;
+}
+
+// Temperature from the internal energy as in PeleC::computeTemp: with the
+// equation of state (compute_temp), with the Newton iterations of
+// pelec.temp_newton on the polynomials (compute_temp_newton) or on the
+// tables (compute_temp_table). Every call starts from a temperature 1% off,
+// as after an energy update.
+BenchResult
+bench_compute_temp(
+  const std::string& name, const BenchContext& ctx, const int variant)
+{
+  const bool table = variant == 2;
+  const auto thermo = thermo_view(ctx, table);
+  const amrex::Box bx = ctx.bx;
+  amrex::FArrayBox S(bx, NVAR, amrex::The_Async_Arena());
+  auto const& s = S.array();
+  const auto u = ctx.U.const_array();
+  const amrex::Real tol = 1.0e-10;
+  const int maxiter = 20;
+
+  const amrex::Long cells = bx.numPts();
+  auto res = run_benchmark(
+    name, ctx, cells, cells * (NUM_SPECIES + 4) * rsize,
+    [=]() {
+      amrex::ParallelFor(
+        bx, NVAR, [=] AMREX_GPU_DEVICE(int i, int j, int k, int n) noexcept {
+          s(i, j, k, n) = (n == UTEMP) ? 0.99 * u(i, j, k, n) : u(i, j, k, n);
+        });
+    },
+    [=]() {
+      amrex::ParallelFor(
+        bx, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
+          if (variant == 0) {
+            pc_cmpTemp(i, j, k, s);
+          } else if (variant == 1) {
+            pc_cmpTemp_newton(i, j, k, s, tol, maxiter);
+          } else {
+            auto eos = pele::physics::PhysicsType::eos();
+            amrex::Real imw[NUM_SPECIES];
+            eos.inv_molecular_weight(imw);
+            const amrex::Real rhoInv = 1.0 / s(i, j, k, URHO);
+            const amrex::Real e = s(i, j, k, UEINT) * rhoInv;
+            amrex::Real massfrac[NUM_SPECIES];
+            amrex::Real Rmix = 0.0;
+            for (int n = 0; n < NUM_SPECIES; ++n) {
+              massfrac[n] = s(i, j, k, UFS + n) * rhoInv;
+              Rmix += massfrac[n] * imw[n];
+            }
+            Rmix *= pele::physics::Constants::RU;
+            amrex::Real T = s(i, j, k, UTEMP);
+            bool converged = false;
+            for (int iter = 0; (iter < maxiter) && !converged; ++iter) {
+              amrex::Real hi[NUM_SPECIES];
+              amrex::Real cpi[NUM_SPECIES];
+              thermo.T2Hi(T, hi);
+              thermo.T2Cpi(T, cpi);
+              amrex::Real h = 0.0;
+              amrex::Real cp = 0.0;
+              for (int n = 0; n < NUM_SPECIES; ++n) {
+                h += massfrac[n] * hi[n];
+                cp += massfrac[n] * cpi[n];
+              }
+              converged = pc_temp_newton_update(e, Rmix, h, cp, tol, T);
+            }
+            s(i, j, k, UTEMP) = T;
+          }
+        });
+    });
+  pele::pelec::ThermoTable::clear();
+  return res;
+}
+
+BenchResult
+bench_filter(const BenchContext& ctx)
+{
+  Filter les_filter(ctx.filter_type, ctx.filter_fgr);
+  if (les_filter.get_filter_ngrow() > ctx.ngrow) {
+    amrex::Abort("bench: filter stencil is wider than the ghost cells");
+  }
+  amrex::FArrayBox out(ctx.bx, NVAR, amrex::The_Async_Arena());
+
+  const amrex::Long cells = ctx.bx.numPts();
+  return run_benchmark(
+    "filter", ctx, cells, cells * 2 * NVAR * rsize,
+    [&]() { les_filter.apply_filter(ctx.bx, ctx.U, out, 0, NVAR); });
+}
+
+BenchResult
+bench_les_smagorinsky(const BenchContext& ctx)
+{
+  amrex::FArrayBox tander[AMREX_SPACEDIM];
+  amrex::FArrayBox area[AMREX_SPACEDIM];
+  amrex::FArrayBox flux[AMREX_SPACEDIM];
+  fill_tangential_derivs(ctx, tander);
+  fill_areas(ctx, area);
+  for (int dir = 0; dir < AMREX_SPACEDIM; ++dir) {
+    flux[dir].resize(
+      amrex::surroundingNodes(ctx.bx, dir), NVAR, amrex::The_Async_Arena());
+    flux[dir].setVal<amrex::RunOn::Device>(0.0);
+  }
+
+  const auto q = ctx.Q.const_array();
+  const auto dx = ctx.geom.CellSizeArray();
+  const amrex::Real Cs = 0.16;
+  const amrex::Real CI = 0.09;
+  const amrex::Real PrT = 0.7;
+  const amrex::Long cells = num_faces(ctx.bx);
+  return run_benchmark(
+    "les_smagorinsky_sfs", ctx, cells,
+    cells * (2 * QVAR + GradUtils::nCompTan + 1 + NVAR) * rsize, [&]() {
+      for (int dir = 0; dir < AMREX_SPACEDIM; ++dir) {
+        const amrex::Box ebox = amrex::surroundingNodes(ctx.bx, dir);
+        auto const& td = tander[dir].const_array();
+        auto const& a = area[dir].const_array();
+        auto const& flx = flux[dir].array();
+        const amrex::Real delta = dx[dir];
+        amrex::ParallelFor(
+          ebox, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
+            pc_smagorinsky_sfs_term(
+              i, j, k, q, td, a, delta, dir, Cs, CI, PrT, flx);
+          });
+      }
+    });
+}
+
+BenchResult
+bench_les_dynamic(const BenchContext& ctx)
+{
+  // The model coefficients and filtered quantities are synthetic constants,
+  // only the flux evaluation is timed
+  amrex::FArrayBox coeff[AMREX_SPACEDIM];
+  amrex::FArrayBox alphaij[AMREX_SPACEDIM];
+  amrex::FArrayBox alpha[AMREX_SPACEDIM];
+  amrex::FArrayBox flux_T[AMREX_SPACEDIM];
+  amrex::FArrayBox area[AMREX_SPACEDIM];
+  amrex::FArrayBox flux[AMREX_SPACEDIM];
+  fill_areas(ctx, area);
+  for (int dir = 0; dir < AMREX_SPACEDIM; ++dir) {
+    const amrex::Box ebox = amrex::surroundingNodes(ctx.bx, dir);
+    coeff[dir].resize(ebox, nCompC, amrex::The_Async_Arena());
+    coeff[dir].setVal<amrex::RunOn::Device>(0.02, comp_Cs2);
+    coeff[dir].setVal<amrex::RunOn::Device>(0.01, comp_CI);
+    coeff[dir].setVal<amrex::RunOn::Device>(0.03, comp_PrT);
+    alphaij[dir].resize(ebox, AMREX_SPACEDIM, amrex::The_Async_Arena());
+    alphaij[dir].setVal<amrex::RunOn::Device>(1.0e2);
+    alpha[dir].resize(ebox, 1, amrex::The_Async_Arena());
+    alpha[dir].setVal<amrex::RunOn::Device>(1.0e2);
+    flux_T[dir].resize(ebox, 1, amrex::The_Async_Arena());
+    flux_T[dir].setVal<amrex::RunOn::Device>(1.0e3);
+    flux[dir].resize(ebox, NVAR, amrex::The_Async_Arena());
+    flux[dir].setVal<amrex::RunOn::Device>(0.0);
+  }
+
+  const auto q = ctx.Q.const_array();
+  const amrex::Long cells = num_faces(ctx.bx);
+  return run_benchmark(
+    "les_dynamic_sfs", ctx, cells,
+    cells * (2 * QVAR + nCompC + AMREX_SPACEDIM + 3 + NVAR) * rsize, [&]() {
+      for (int dir = 0; dir < AMREX_SPACEDIM; ++dir) {
+        const amrex::Box ebox = amrex::surroundingNodes(ctx.bx, dir);
+        auto const& aij = alphaij[dir].const_array();
+        auto const& al = alpha[dir].const_array();
+        auto const& fT = flux_T[dir].const_array();
+        auto const& cf = coeff[dir].const_array();
+        auto const& a = area[dir].const_array();
+        auto const& flx = flux[dir].array();
+        amrex::ParallelFor(
+          ebox, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
+            pc_dynamic_smagorinsky_sfs_term(
+              i, j, k, q, aij, al, fT, cf, a, dir, flx);
+          });
+      }
+    });
+}
+
+// 1D profile interpolation as done per cell by the PMF problem setups in
+// their initial and boundary conditions: linear search through the profile
+// (the original approach) or O(1) ProfileTable lookup. The synthetic
+// profile is refined around a flame front, like a premixed flame solution.
+BenchResult
+bench_pmf(const std::string& name, const BenchContext& ctx, const bool table)
+{
+  const int np = ctx.pmf_points;
+  const int nv = NUM_SPECIES + 3;
+  amrex::Vector<amrex::Real> xp(np);
+  amrex::Vector<amrex::Real> yp(static_cast<amrex::Long>(np) * nv);
+  for (int i = 0; i < np; i++) {
+    const amrex::Real s = -1.0 + 2.0 * i / (np - 1);
+    xp[i] = s * s * s;
+    for (int j = 0; j < nv; j++) {
+      yp[j * np + i] = std::tanh(10.0 * xp[i]) + 0.1 * j;
+    }
+  }
+  pele::pelec::ProfileTable ptable;
+  ptable.define(xp, yp, nv);
+  const auto pt = ptable.deviceData();
+
+  const int dir = AMREX_SPACEDIM - 1;
+  const int nz = ctx.bx.length(dir);
+  const int zlo = ctx.bx.smallEnd(dir);
+  amrex::FArrayBox vals(ctx.bx, nv, amrex::The_Async_Arena());
+  const auto varr = vals.array();
+
+  const amrex::Long cells = ctx.bx.numPts();
+  return run_benchmark(
+    name, ctx, cells, cells * nv * rsize, [&]() {
+      amrex::ParallelFor(
+        ctx.bx, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
+          const amrex::IntVect iv(AMREX_D_DECL(i, j, k));
+          const amrex::Real xq = -1.2 + 2.4 * (iv[dir] - zlo + 0.5) / nz;
+          if (table) {
+            const int lo = pt.interval(xq);
+            for (int n = 0; n < nv; n++) {
+              varr(i, j, k, n) = pt.value(lo, n, xq);
+            }
+          } else {
+            int lo = -1;
+            int hi = -1;
+            if (xq < pt.x[0]) {
+              lo = 0;
+              hi = 0;
+            }
+            if (xq > pt.x[np - 1]) {
+              lo = np - 1;
+              hi = np - 1;
+            }
+            if (lo == -1) {
+              for (int m = 0; m < np - 1; m++) {
+                if ((xq >= pt.x[m]) && (xq <= pt.x[m + 1])) {
+                  lo = m;
+                  hi = m + 1;
+                }
+              }
+            }
+            for (int n = 0; n < nv; n++) {
+              const amrex::Real y1 = pt.y[n * np + lo];
+              const amrex::Real y2 = pt.y[n * np + hi];
+              const amrex::Real dydx =
+                (lo == hi) ? 0.0 : (y2 - y1) / (pt.x[hi] - pt.x[lo]);
+              varr(i, j, k, n) = y1 + dydx * (xq - pt.x[lo]);
+            }
+          }
+        });
+    });
+}
+
+#if NUM_SPECIES > 1
+BenchResult
+bench_entropy_inequality(const BenchContext& ctx)
+{
+  const int ncomp = ei_spec + NUM_SPECIES + NUM_REACTIONS;
+  amrex::FArrayBox derfab(ctx.bx, ncomp, amrex::The_Async_Arena());
+
+  const amrex::Long cells = ctx.bx.numPts();
+  return run_benchmark(
+    "entropy_inequality", ctx, cells, cells * (NVAR + ncomp) * rsize, [&]() {
+      // Include the gradients, which would otherwise be reused from the cache
+      pele::pelec::GradientCache::level(0).clear();
+      PeleC::pc_entropyInequality(
+        ctx.bx, derfab, 0, ncomp, ctx.U, ctx.geom, 0.0, nullptr, 0);
+    });
+}
+#endif
+
+BenchResult
+bench_react(const BenchContext& ctx)
+{
+  auto reactor =
+    pele::physics::reactions::ReactorBase::create(ctx.chem_integrator);
+  reactor->init(1, 1);
+
+  // Same packing as PeleC::react_state
+  const amrex::Box bx = ctx.bx;
+  amrex::FArrayBox STemp(bx, NUM_SPECIES + 2, amrex::The_Async_Arena());
+  amrex::FArrayBox extsrc_rY(bx, NUM_SPECIES, amrex::The_Async_Arena());
+  amrex::FArrayBox extsrc_rE(bx, 1, amrex::The_Async_Arena());
+  amrex::IArrayBox dummyMask(bx, 1, amrex::The_Async_Arena());
+  amrex::FArrayBox fctCount(bx, 1, amrex::The_Async_Arena());
+  extsrc_rY.setVal<amrex::RunOn::Device>(0.0);
+  extsrc_rE.setVal<amrex::RunOn::Device>(0.0);
+  dummyMask.setVal<amrex::RunOn::Device>(1);
+
+  auto const& rhoY = STemp.array();
+  auto const& T = STemp.array(NUM_SPECIES);
+  auto const& rhoE = STemp.array(NUM_SPECIES + 1);
+  auto const& frcExt = extsrc_rY.array();
+  auto const& frcEExt = extsrc_rE.array();
+  auto const& mask = dummyMask.array();
+  auto const& fc = fctCount.array();
+  const auto u = ctx.U.const_array();
+  const amrex::Real dt = ctx.dt;
+
+  const amrex::Long cells = bx.numPts();
+  auto res = run_benchmark(
+    "react", ctx, cells, cells * 2 * (2 * NUM_SPECIES + 3) * rsize,
+    [=]() {
+      // Reset to the unreacted state before every call
+      amrex::ParallelFor(
+        bx, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
+          for (int n = 0; n < NUM_SPECIES; ++n) {
+            rhoY(i, j, k, n) = u(i, j, k, UFS + n);
+          }
+          T(i, j, k) = u(i, j, k, UTEMP);
+          rhoE(i, j, k) = u(i, j, k, UEINT);
+        });
+    },
+    [&]() {
+      amrex::Real current_time = 0.0;
+      reactor->react(
+        bx, rhoY, frcExt, T, rhoE, frcEExt, fc, mask, dt, current_time
+#ifdef AMREX_USE_GPU
+        ,
+        amrex::Gpu::gpuStream()
+#endif
+      );
+    });
+  reactor->close();
+  return res;
+}
+
+} // namespace
+
+void
+init_context(BenchContext& ctx)
+{
+  amrex::ParmParse pp("bench");
+
+  amrex::Vector<int> n_cell(AMREX_SPACEDIM, 64);
+  pp.queryarr("n_cell", n_cell, 0, AMREX_SPACEDIM);
+  pp.query("nwarm", ctx.nwarm);
+  pp.query("nrep", ctx.nrep);
+  pp.query("dt", ctx.dt);
+  pp.query("filter_type", ctx.filter_type);
+  pp.query("filter_fgr", ctx.filter_fgr);
+  pp.query("pmf_points", ctx.pmf_points);
+  pp.query("thermo_table_Tmin", ctx.thermo_table_Tmin);
+  pp.query("thermo_table_Tmax", ctx.thermo_table_Tmax);
+  pp.query("thermo_table_dT", ctx.thermo_table_dT);
+  pp.query("chem_integrator", ctx.chem_integrator);
+  AMREX_ALWAYS_ASSERT(ctx.nrep > 0 && ctx.nwarm >= 0);
+
+  // Mixture around which the mass fractions are perturbed
+  amrex::GpuArray<amrex::Real, NUM_SPECIES> Y0;
+  amrex::Vector<amrex::Real> mass_fractions;
+  pp.queryarr("mass_fractions", mass_fractions);
+  if (mass_fractions.empty()) {
+    for (int n = 0; n < NUM_SPECIES; ++n) {
+      Y0[n] = 1.0 / NUM_SPECIES;
+    }
+  } else if (mass_fractions.size() == NUM_SPECIES) {
+    for (int n = 0; n < NUM_SPECIES; ++n) {
+      Y0[n] = mass_fractions[n];
+    }
+  } else {
+    amrex::Abort("bench.mass_fractions needs one entry per species");
+  }
+  amrex::Real T0 = 1200.0;
+  amrex::Real p0 = 1013250.0;
+  amrex::Real u0 = 1.0e3;
+  pp.query("T0", T0);
+  pp.query("p0", p0);
+  pp.query("u0", u0);
+
+  ctx.bx = amrex::Box(
+    amrex::IntVect::TheZeroVector(),
+    amrex::IntVect(AMREX_D_DECL(n_cell[0] - 1, n_cell[1] - 1, n_cell[2] - 1)));
+  const amrex::RealBox rb(
+    {AMREX_D_DECL(0.0, 0.0, 0.0)}, {AMREX_D_DECL(1.0, 1.0, 1.0)});
+  const amrex::Array<int, AMREX_SPACEDIM> is_periodic{
+    AMREX_D_DECL(1, 1, 1)};
+  ctx.geom.define(ctx.bx, rb, amrex::CoordSys::cartesian, is_periodic);
+
+  const amrex::Box gbx = amrex::grow(ctx.bx, ctx.ngrow);
+  ctx.U.resize(gbx, NVAR);
+  ctx.Q.resize(gbx, QVAR);
+  ctx.QA.resize(gbx, nqaux);
+  ctx.U.setVal<amrex::RunOn::Device>(0.0);
+
+  // Smooth periodic fields with O(1) variations of T, Y and u
+  const auto geomdata = ctx.geom.data();
+  auto const& u = ctx.U.array();
+  amrex::ParallelFor(gbx, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
+    const amrex::IntVect iv{AMREX_D_DECL(i, j, k)};
+    amrex::Real x[3] = {0.0};
+    for (int d = 0; d < AMREX_SPACEDIM; ++d) {
+      x[d] = geomdata.ProbLo(d) + (iv[d] + 0.5) * geomdata.CellSize(d);
+    }
+    const amrex::Real tpi = 2.0 * constants::PI();
+    const amrex::Real T =
+      T0 * (1.0 + 0.5 * std::sin(tpi * x[0]) * std::cos(tpi * x[1]));
+    const amrex::Real p = p0 * (1.0 + 0.05 * std::cos(tpi * x[2]));
+    amrex::Real massfrac[NUM_SPECIES] = {0.0};
+    amrex::Real sum = 0.0;
+    for (int n = 0; n < NUM_SPECIES; ++n) {
+      const amrex::Real phase = static_cast<amrex::Real>(n) / NUM_SPECIES;
+      massfrac[n] =
+        Y0[n] * (1.0 + 0.2 * std::sin(tpi * (x[0] + x[1] + phase)));
+      sum += massfrac[n];
+    }
+    for (int n = 0; n < NUM_SPECIES; ++n) {
+      massfrac[n] /= sum;
+    }
+    const amrex::Real vel[3] = {
+      u0 * std::sin(tpi * x[1]), u0 * std::sin(tpi * x[2]),
+      u0 * std::sin(tpi * x[0])};
+
+    auto eos = pele::physics::PhysicsType::eos();
+    amrex::Real rho = 0.0;
+    amrex::Real e = 0.0;
+    eos.PYT2RE(p, massfrac, T, rho, e);
+
+    u(iv, URHO) = rho;
+    u(iv, UMX) = rho * vel[0];
+    u(iv, UMY) = rho * vel[1];
+    u(iv, UMZ) = rho * vel[2];
+    u(iv, UEINT) = rho * e;
+    u(iv, UEDEN) =
+      rho * (e + 0.5 * (vel[0] * vel[0] + vel[1] * vel[1] + vel[2] * vel[2]));
+    u(iv, UTEMP) = T;
+    for (int n = 0; n < NUM_SPECIES; ++n) {
+      u(iv, UFS + n) = rho * massfrac[n];
+    }
+  });
+
+  const auto uc = ctx.U.const_array();
+  auto const& q = ctx.Q.array();
+  auto const& qa = ctx.QA.array();
+  amrex::ParallelFor(gbx, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
+    pc_ctoprim(i, j, k, uc, q, qa);
+  });
+  amrex::Gpu::streamSynchronize();
+}
+
+amrex::Vector<std::string>
+available_kernels()
+{
+  return {
+    "ctoprim",
+    "riemann",
+    "ppm",
+    "plm",
+    "weno5",
+    "weno7",
+    "diffusion_flux",
+    "diffusion_flux_table",
+    "compute_temp",
+    "compute_temp_newton",
+    "compute_temp_table",
+    "filter",
+    "les_smagorinsky_sfs",
+    "les_dynamic_sfs",
+    "pmf_search",
+    "pmf_table",
+#if NUM_SPECIES > 1
+    "entropy_inequality",
+#endif
+    "react"};
+}
+
+amrex::Vector<BenchResult>
+run_kernels(BenchContext& ctx, const amrex::Vector<std::string>& kernels)
+{
+  amrex::Vector<BenchResult> results;
+  for (const auto& kname : kernels) {
+    BL_PROFILE("pelec_bench::" + kname);
+    if (kname == "ctoprim") {
+      results.push_back(bench_ctoprim(ctx));
+    } else if (kname == "riemann") {
+      results.push_back(bench_riemann(ctx));
+    } else if (kname == "ppm") {
+      results.push_back(bench_reconstruction<PPMRecon>(kname, ctx));
+    } else if (kname == "plm") {
+      results.push_back(bench_plm(ctx));
+    } else if (kname == "weno5") {
+      results.push_back(bench_reconstruction<WENO5Recon>(kname, ctx));
+    } else if (kname == "weno7") {
+      results.push_back(bench_reconstruction<WENO7Recon>(kname, ctx));
+    } else if (kname == "diffusion_flux") {
+      results.push_back(bench_diffusion_flux(kname, ctx, false));
+    } else if (kname == "diffusion_flux_table") {
+      results.push_back(bench_diffusion_flux(kname, ctx, true));
+    } else if (kname == "compute_temp") {
+      results.push_back(bench_compute_temp(kname, ctx, 0));
+    } else if (kname == "compute_temp_newton") {
+      results.push_back(bench_compute_temp(kname, ctx, 1));
+    } else if (kname == "compute_temp_table") {
+      results.push_back(bench_compute_temp(kname, ctx, 2));
+    } else if (kname == "filter") {
+      results.push_back(bench_filter(ctx));
+    } else if (kname == "les_smagorinsky_sfs") {
+      results.push_back(bench_les_smagorinsky(ctx));
+    } else if (kname == "les_dynamic_sfs") {
+      results.push_back(bench_les_dynamic(ctx));
+    } else if (kname == "pmf_search") {
+      results.push_back(bench_pmf(kname, ctx, false));
+    } else if (kname == "pmf_table") {
+      results.push_back(bench_pmf(kname, ctx, true));
+#if NUM_SPECIES > 1
+    } else if (kname == "entropy_inequality") {
+      results.push_back(bench_entropy_inequality(ctx));
+#endif
+    } else if (kname == "react") {
+      results.push_back(bench_react(ctx));
+    } else {
+      amrex::Abort("bench: unknown kernel " + kname);
+    }
+  }
+  return results;
+}
+
+} // namespace pelec_bench
@@ -0,0 +1,128 @@
+/** \file benchmark-main.cpp
+ *  Entry point for the PeleC kernel micro-benchmarks
+ *
+ *  Runs the selected kernels on a synthetic box, prints a table of cells/s
+ *  and GB/s and writes a JSON baseline that can be diffed across commits.
+ */
+
+#include <fstream>
+#include <iomanip>
+
+#include <AMReX.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Print.H>
+
+// Defined and initialized when in gnumake, but not defined in cmake and
+// initialization done manually
+#ifndef AMREX_USE_SUNDIALS
+#include <AMReX_Sundials.H>
+#endif
+
+#include "PeleC.H"
+#include "Benchmark.H"
+
+namespace amrex {
+const char* buildInfoGetGitHash(int i);
+}
+
+#ifndef PELEC_BENCHMARK_MECHANISM
+#define PELEC_BENCHMARK_MECHANISM "unknown"
+#endif
+
+// Necessary as it's used in other source files
+std::string inputs_name;
+
+namespace {
+
+void
+write_json(
+  const std::string& fname,
+  const pelec_bench::BenchContext& ctx,
+  const amrex::Vector<pelec_bench::BenchResult>& results)
+{
+  std::ofstream os(fname);
+  os << std::setprecision(8);
+  os << "{\n";
+  os << "  \"pelec_git\": \"" << amrex::buildInfoGetGitHash(1) << "\",\n";
+  os << "  \"amrex_git\": \"" << amrex::buildInfoGetGitHash(2) << "\",\n";
+  os << "  \"mechanism\": \"" << PELEC_BENCHMARK_MECHANISM << "\",\n";
+  os << "  \"num_species\": " << NUM_SPECIES << ",\n";
+  os << "  \"dim\": " << AMREX_SPACEDIM << ",\n";
+  os << "  \"n_cell\": [";
+  for (int d = 0; d < AMREX_SPACEDIM; ++d) {
+    os << (d > 0 ? ", " : "") << ctx.bx.length(d);
+  }
+  os << "],\n";
+  os << "  \"nprocs\": " << amrex::ParallelDescriptor::NProcs() << ",\n";
+#ifdef AMREX_USE_GPU
+  os << "  \"gpu\": true,\n";
+#else
+  os << "  \"gpu\": false,\n";
+#endif
+  os << "  \"kernels\": {\n";
+  for (int r = 0; r < results.size(); ++r) {
+    const auto& res = results[r];
+    os << "    \"" << res.name << "\": {\"cells\": " << res.cells
+       << ", \"bytes\": " << res.bytes << ", \"reps\": " << res.reps
+       << ", \"t_min\": " << res.t_min << ", \"t_mean\": " << res.t_mean
+       << ", \"t_max\": " << res.t_max
+       << ", \"cells_per_s\": " << res.cells_per_s()
+       << ", \"bytes_per_s\": " << res.bytes_per_s() << "}"
+       << (r < results.size() - 1 ? "," : "") << "\n";
+  }
+  os << "  }\n";
+  os << "}\n";
+}
+
+} // namespace
+
+int
+main(int argc, char* argv[])
+{
+  amrex::Initialize(argc, argv);
+#ifndef AMREX_USE_SUNDIALS
+  amrex::sundials::Initialize(amrex::OpenMP::get_max_threads());
+#endif
+  {
+    amrex::ParmParse pp("bench");
+    amrex::Vector<std::string> kernels = pelec_bench::available_kernels();
+    pp.queryarr("kernels", kernels);
+    std::string output = "pelec_benchmarks.json";
+    pp.query("output", output);
+
+    PeleC::trans_parms.allocate();
+    PeleC::init_reaction_stoich();
+
+    pelec_bench::BenchContext ctx;
+    pelec_bench::init_context(ctx);
+
+    amrex::Print() << "PeleC kernel benchmarks: " << PELEC_BENCHMARK_MECHANISM
+                   << ", " << NUM_SPECIES << " species, box " << ctx.bx
+                   << ", " << ctx.nrep << " repetitions" << std::endl;
+
+    const auto results = pelec_bench::run_kernels(ctx, kernels);
+
+    amrex::Print() << std::setw(24) << "kernel" << std::setw(14) << "min [s]"
+                   << std::setw(14) << "mean [s]" << std::setw(14)
+                   << "Mcells/s" << std::setw(14) << "GB/s" << "\n";
+    for (const auto& res : results) {
+      amrex::Print() << std::setw(24) << res.name << std::setw(14) << res.t_min
+                     << std::setw(14) << res.t_mean << std::setw(14)
+                     << 1.0e-6 * res.cells_per_s() << std::setw(14)
+                     << 1.0e-9 * res.bytes_per_s() << "\n";
+    }
+
+    if (amrex::ParallelDescriptor::IOProcessor() && !output.empty()) {
+      write_json(output, ctx, results);
+      amrex::Print() << "Baseline written to " << output << std::endl;
+    }
+
+    PeleC::free_reaction_stoich();
+    PeleC::trans_parms.deallocate();
+  }
+#ifndef AMREX_USE_SUNDIALS
+  amrex::sundials::Finalize();
+#endif
+  amrex::Finalize();
+  return 0;
+}
@@ -5,6 +5,147 @@ pc_prob_close()
 {
 }
 
+namespace {
+
+void
+copy_input_to_device()
+{
+  PeleC::prob_parm_host->uinput.resize(PeleC::prob_parm_host->h_uinput.size());
+  PeleC::prob_parm_host->vinput.resize(PeleC::prob_parm_host->h_vinput.size());
+  PeleC::prob_parm_host->winput.resize(PeleC::prob_parm_host->h_winput.size());
+  amrex::Gpu::copy(
+    amrex::Gpu::hostToDevice, PeleC::prob_parm_host->h_uinput.begin(),
+    PeleC::prob_parm_host->h_uinput.end(),
+    PeleC::prob_parm_host->uinput.begin());
+  amrex::Gpu::copy(
+    amrex::Gpu::hostToDevice, PeleC::prob_parm_host->h_vinput.begin(),
+    PeleC::prob_parm_host->h_vinput.end(),
+    PeleC::prob_parm_host->vinput.begin());
+  amrex::Gpu::copy(
+    amrex::Gpu::hostToDevice, PeleC::prob_parm_host->h_winput.begin(),
+    PeleC::prob_parm_host->h_winput.end(),
+    PeleC::prob_parm_host->winput.begin());
+  PeleC::h_prob_parm_device->d_uinput = PeleC::prob_parm_host->uinput.data();
+  PeleC::h_prob_parm_device->d_vinput = PeleC::prob_parm_host->vinput.data();
+  PeleC::h_prob_parm_device->d_winput = PeleC::prob_parm_host->winput.data();
+  PeleC::prob_parm_host->blocks.resize(PeleC::prob_parm_host->h_blocks.size());
+  amrex::Gpu::copy(
+    amrex::Gpu::hostToDevice, PeleC::prob_parm_host->h_blocks.begin(),
+    PeleC::prob_parm_host->h_blocks.end(),
+    PeleC::prob_parm_host->blocks.begin());
+  PeleC::h_prob_parm_device->nblocks =
+    static_cast<int>(PeleC::prob_parm_host->h_blocks.size());
+  PeleC::h_prob_parm_device->d_blocks = PeleC::prob_parm_host->blocks.data();
+}
+
+// Host version of locate
+int
+locate_host(const amrex::Vector<amrex::Real>& xtable, const amrex::Real x)
+{
+  const int n = static_cast<int>(xtable.size());
+  if (x >= xtable[n - 1]) {
+    return n - 1;
+  }
+  if (x <= xtable[0]) {
+    return 0;
+  }
+  return static_cast<int>(
+           std::upper_bound(xtable.begin(), xtable.end(), x) -
+           xtable.begin()) -
+         1;
+}
+
+// Read the blocks of the input cube needed to interpolate onto the boxes
+// owned by this rank on level lev, i.e. the input points bracketing the cell
+// centers of each local box, with the blocks of neighbouring boxes merged
+void
+hit_init_level(int lev, const amrex::Geometry& geom, const amrex::MultiFab& S)
+{
+  BL_PROFILE("hit_init_level()");
+  const amrex::Real t0 = amrex::ParallelDescriptor::second();
+  auto* pp = PeleC::h_prob_parm_device;
+  auto& ph = *PeleC::prob_parm_host;
+  const int nx = pp->inres;
+
+  const auto problo = geom.ProbLoArray();
+  const auto dx = geom.CellSizeArray();
+  amrex::Vector<amrex::Box> blocks;
+  for (amrex::MFIter mfi(S); mfi.isValid(); ++mfi) {
+    const amrex::Box& bx = mfi.validbox();
+    amrex::IntVect lo(0);
+    amrex::IntVect hi(0);
+    for (int cnt = 0; cnt < 3; cnt++) {
+      const amrex::Real xa = problo[cnt] + (bx.smallEnd(cnt) + 0.5) * dx[cnt];
+      const amrex::Real xb = problo[cnt] + (bx.bigEnd(cnt) + 0.5) * dx[cnt];
+      const amrex::Real ma = std::fmod(xa, pp->Linput);
+      const amrex::Real mb = std::fmod(xb, pp->Linput);
+      lo[cnt] = locate_host(ph.h_xarray, ma);
+      hi[cnt] = locate_host(ph.h_xarray, mb) + 1;
+      if (mb < ma) {
+        hi[cnt] += nx;
+      }
+      if ((xb - xa >= pp->Linput) || (hi[cnt] - lo[cnt] + 1 >= nx)) {
+        lo[cnt] = 0;
+        hi[cnt] = nx - 1;
+      }
+    }
+    blocks.push_back(amrex::Box(lo, hi));
+  }
+  const amrex::Vector<amrex::Box> wanted = blocks;
+  pele::pelec::BlockReader::coalesce(blocks);
+  // Merging only grows the blocks, so each local box must still sit in one
+  // of them; check it here since the kernel cannot report a miss
+  for (const auto& w : wanted) {
+    bool covered = false;
+    for (const auto& blk : blocks) {
+      covered = covered || blk.contains(w);
+    }
+    if (!covered) {
+      amrex::Abort("HIT input blocks do not cover the local boxes");
+    }
+  }
+
+  amrex::Long npts = 0;
+  for (const auto& blk : blocks) {
+    npts += blk.numPts();
+  }
+  ph.h_uinput.resize(npts);
+  ph.h_vinput.resize(npts);
+  ph.h_winput.resize(npts);
+  ph.h_blocks.resize(blocks.size());
+  const amrex::Real fac = pp->urms0 / pp->uin_norm;
+  const amrex::Long bytes0 = ph.reader->bytesRead();
+  amrex::Vector<double> data;
+  amrex::Long offset = 0;
+  for (int b = 0; b < blocks.size(); b++) {
+    const amrex::Box& blk = blocks[b];
+    ph.reader->read(blk, 3, 3, data);
+    const amrex::Long nb = blk.numPts();
+    for (amrex::Long i = 0; i < nb; i++) {
+      ph.h_uinput[offset + i] = data[i] * fac;
+      ph.h_vinput[offset + i] = data[i + nb] * fac;
+      ph.h_winput[offset + i] = data[i + 2 * nb] * fac;
+    }
+    for (int cnt = 0; cnt < 3; cnt++) {
+      ph.h_blocks[b].lo[cnt] = blk.smallEnd(cnt);
+      ph.h_blocks[b].n[cnt] = blk.length(cnt);
+    }
+    ph.h_blocks[b].offset = offset;
+    offset += nb;
+  }
+  copy_input_to_device();
+
+  amrex::Real stats[2] = {
+    amrex::ParallelDescriptor::second() - t0,
+    static_cast<amrex::Real>(ph.reader->bytesRead() - bytes0) / 1.0e6};
+  amrex::ParallelDescriptor::ReduceRealMax(
+    stats, 2, amrex::ParallelDescriptor::IOProcessorNumber());
+  amrex::Print() << "HIT input read on level " << lev << " in " << stats[0]
+                 << " s, at most " << stats[1] << " MB per rank" << std::endl;
+}
+
+} // namespace
+
 extern "C" {
 void
 amrex_probinit(
@@ -25,6 +166,7 @@ amrex_probinit(
     pp.query("mach_t0", PeleC::h_prob_parm_device->mach_t0);
     pp.query("prandtl", PeleC::h_prob_parm_device->prandtl);
     pp.query("inres", PeleC::h_prob_parm_device->inres);
+    pp.query("use_mmap", PeleC::h_prob_parm_device->use_mmap);
     pp.query("uin_norm", PeleC::h_prob_parm_device->uin_norm);
   }
 
@@ -93,13 +235,12 @@ amrex_probinit(
     << PeleC::h_prob_parm_device->forcing_w0 << std::endl;
   ofs.close();
 
-  // Load velocity fields from file. Assume data set ordered in Fortran
-  // format and reshape the data accordingly. One thing to keep in mind
-  // is that this contains the entire input data. We will interpolate
-  // this data later to just match our box. Another assumption is that
-  // the input data is a periodic cube. If the input cube is smaller
-  // than our domain size, the cube will be repeated throughout the
-  // domain (hence the mod operations in the interpolation).
+  // Load the input field. Assume the data set is a periodic cube ordered in
+  // Fortran format. If the input cube is smaller than our domain size, the
+  // cube will be repeated throughout the domain (hence the mod operations in
+  // the interpolation). Binary inputs are read per level and per rank, only
+  // for the blocks of the cube covering the local boxes (see
+  // hit_init_level). CSV inputs are read entirely by every rank.
   if (PeleC::h_prob_parm_device->restart) {
     amrex::Print() << "Skipping input file reading and assuming restart."
                    << std::endl;
@@ -107,40 +248,52 @@ amrex_probinit(
 #ifdef AMREX_USE_FLOAT
     amrex::Abort("HIT cannot run in single precision at the moment.");
 #else
-    const size_t nx = PeleC::h_prob_parm_device->inres;
-    const size_t ny = PeleC::h_prob_parm_device->inres;
-    const size_t nz = PeleC::h_prob_parm_device->inres;
-    amrex::Vector<amrex::Real> data(
-      nx * ny * nz * 6); /* this needs to be double */
+    const amrex::Real t0 = amrex::ParallelDescriptor::second();
+    const int nx = PeleC::h_prob_parm_device->inres;
+    PeleC::prob_parm_host->h_xarray.resize(nx);
     if (PeleC::h_prob_parm_device->binfmt) {
-      read_binary(PeleC::prob_parm_host->iname, nx, ny, nz, 6, data);
+      PeleC::prob_parm_host->reader =
+        std::make_unique<pele::pelec::BlockReader>(
+          PeleC::prob_parm_host->iname, amrex::IntVect(nx), 6,
+          PeleC::h_prob_parm_device->use_mmap);
+
+      // The x coordinates of the first row give the input grid
+      amrex::Vector<double> xdata;
+      PeleC::prob_parm_host->reader->read(
+        amrex::Box(amrex::IntVect(0), amrex::IntVect(nx - 1, 0, 0)), 0, 1,
+        xdata);
+      for (int i = 0; i < nx; i++) {
+        PeleC::prob_parm_host->h_xarray[i] = xdata[i];
+      }
+      PeleC::prob_init_level = hit_init_level;
     } else {
-      read_csv(PeleC::prob_parm_host->iname, nx, ny, nz, data);
-    }
+      const size_t npts = static_cast<size_t>(nx) * nx * nx;
+      amrex::Vector<amrex::Real> data(npts * 6);
+      read_csv(PeleC::prob_parm_host->iname, nx, nx, nx, data);
 
-    // Extract position and velocities
-    PeleC::prob_parm_host->h_xinput.resize(nx * ny * nz);
-    PeleC::prob_parm_host->h_uinput.resize(nx * ny * nz);
-    PeleC::prob_parm_host->h_vinput.resize(nx * ny * nz);
-    PeleC::prob_parm_host->h_winput.resize(nx * ny * nz);
-    for (long i = 0; i < PeleC::prob_parm_host->h_xinput.size(); i++) {
-      PeleC::prob_parm_host->h_xinput[i] = data[0 + i * 6];
-      PeleC::prob_parm_host->h_uinput[i] = data[3 + i * 6] *
-                                           PeleC::h_prob_parm_device->urms0 /
-                                           PeleC::h_prob_parm_device->uin_norm;
-      PeleC::prob_parm_host->h_vinput[i] = data[4 + i * 6] *
-                                           PeleC::h_prob_parm_device->urms0 /
-                                           PeleC::h_prob_parm_device->uin_norm;
-      PeleC::prob_parm_host->h_winput[i] = data[5 + i * 6] *
-                                           PeleC::h_prob_parm_device->urms0 /
-                                           PeleC::h_prob_parm_device->uin_norm;
+      // Extract position and velocities, the whole cube is kept
+      PeleC::prob_parm_host->h_uinput.resize(npts);
+      PeleC::prob_parm_host->h_vinput.resize(npts);
+      PeleC::prob_parm_host->h_winput.resize(npts);
+      const amrex::Real fac =
+        PeleC::h_prob_parm_device->urms0 / PeleC::h_prob_parm_device->uin_norm;
+      for (size_t i = 0; i < npts; i++) {
+        PeleC::prob_parm_host->h_uinput[i] = data[3 + i * 6] * fac;
+        PeleC::prob_parm_host->h_vinput[i] = data[4 + i * 6] * fac;
+        PeleC::prob_parm_host->h_winput[i] = data[5 + i * 6] * fac;
+      }
+      for (int i = 0; i < nx; i++) {
+        PeleC::prob_parm_host->h_xarray[i] = data[i * 6];
+      }
+      PeleC::prob_parm_host->h_blocks.resize(1);
+      for (int cnt = 0; cnt < 3; cnt++) {
+        PeleC::prob_parm_host->h_blocks[0].lo[cnt] = 0;
+        PeleC::prob_parm_host->h_blocks[0].n[cnt] = nx;
+      }
+      copy_input_to_device();
     }
 
     // Get the xarray table and the differences.
-    PeleC::prob_parm_host->h_xarray.resize(nx);
-    for (long i = 0; i < PeleC::prob_parm_host->h_xarray.size(); i++) {
-      PeleC::prob_parm_host->h_xarray[i] = PeleC::prob_parm_host->h_xinput[i];
-    }
     PeleC::prob_parm_host->h_xdiff.resize(nx);
     std::adjacent_difference(
       PeleC::prob_parm_host->h_xarray.begin(),
@@ -156,33 +309,9 @@ amrex_probinit(
     }
 
     // Get pointer to the data
-    PeleC::prob_parm_host->xinput.resize(
-      PeleC::prob_parm_host->h_xinput.size());
-    PeleC::prob_parm_host->uinput.resize(
-      PeleC::prob_parm_host->h_uinput.size());
-    PeleC::prob_parm_host->vinput.resize(
-      PeleC::prob_parm_host->h_vinput.size());
-    PeleC::prob_parm_host->winput.resize(
-      PeleC::prob_parm_host->h_winput.size());
     PeleC::prob_parm_host->xarray.resize(
       PeleC::prob_parm_host->h_xarray.size());
     PeleC::prob_parm_host->xdiff.resize(PeleC::prob_parm_host->h_xdiff.size());
-    amrex::Gpu::copy(
-      amrex::Gpu::hostToDevice, PeleC::prob_parm_host->h_xinput.begin(),
-      PeleC::prob_parm_host->h_xinput.end(),
-      PeleC::prob_parm_host->xinput.begin());
-    amrex::Gpu::copy(
-      amrex::Gpu::hostToDevice, PeleC::prob_parm_host->h_uinput.begin(),
-      PeleC::prob_parm_host->h_uinput.end(),
-      PeleC::prob_parm_host->uinput.begin());
-    amrex::Gpu::copy(
-      amrex::Gpu::hostToDevice, PeleC::prob_parm_host->h_vinput.begin(),
-      PeleC::prob_parm_host->h_vinput.end(),
-      PeleC::prob_parm_host->vinput.begin());
-    amrex::Gpu::copy(
-      amrex::Gpu::hostToDevice, PeleC::prob_parm_host->h_winput.begin(),
-      PeleC::prob_parm_host->h_winput.end(),
-      PeleC::prob_parm_host->winput.begin());
     amrex::Gpu::copy(
       amrex::Gpu::hostToDevice, PeleC::prob_parm_host->h_xarray.begin(),
       PeleC::prob_parm_host->h_xarray.end(),
@@ -191,11 +320,6 @@ amrex_probinit(
       amrex::Gpu::hostToDevice, PeleC::prob_parm_host->h_xdiff.begin(),
       PeleC::prob_parm_host->h_xdiff.end(),
       PeleC::prob_parm_host->xdiff.begin());
-
-    PeleC::h_prob_parm_device->d_xinput = PeleC::prob_parm_host->xinput.data();
-    PeleC::h_prob_parm_device->d_uinput = PeleC::prob_parm_host->uinput.data();
-    PeleC::h_prob_parm_device->d_vinput = PeleC::prob_parm_host->vinput.data();
-    PeleC::h_prob_parm_device->d_winput = PeleC::prob_parm_host->winput.data();
     PeleC::h_prob_parm_device->d_xarray = PeleC::prob_parm_host->xarray.data();
     PeleC::h_prob_parm_device->d_xdiff = PeleC::prob_parm_host->xdiff.data();
 
@@ -203,6 +327,12 @@ amrex_probinit(
     PeleC::h_prob_parm_device->Linput =
       PeleC::prob_parm_host->h_xarray[nx - 1] +
       0.5 * PeleC::prob_parm_host->h_xdiff[nx - 1];
+
+    amrex::Real tread = amrex::ParallelDescriptor::second() - t0;
+    amrex::ParallelDescriptor::ReduceRealMax(
+      tread, amrex::ParallelDescriptor::IOProcessorNumber());
+    amrex::Print() << "HIT input " << PeleC::prob_parm_host->iname
+                   << " opened in " << tread << " s" << std::endl;
 #endif
   }
 }
@@ -216,6 +346,9 @@ PeleC::problem_post_timestep()
 void
 PeleC::problem_post_init()
 {
+  // The input data is only needed to initialize the levels
+  prob_init_level = nullptr;
+  prob_parm_host->reader.reset();
 }
 
 void
@@ -103,6 +103,18 @@ read_pmf(const std::string& myfile)
     PeleC::prob_parm_host->h_pmf_Y.end(), PeleC::prob_parm_host->pmf_Y.begin());
   PeleC::h_prob_parm_device->d_pmf_X = PeleC::prob_parm_host->pmf_X.data();
   PeleC::h_prob_parm_device->d_pmf_Y = PeleC::prob_parm_host->pmf_Y.data();
+
+  // Table with precomputed slopes for O(1) lookups, checked against a
+  // linear search through the original profile
+  PeleC::prob_parm_host->pmf_table.define(
+    PeleC::prob_parm_host->h_pmf_X, PeleC::prob_parm_host->h_pmf_Y,
+    PeleC::h_prob_parm_device->pmf_M);
+  PeleC::h_prob_parm_device->pmf_table =
+    PeleC::prob_parm_host->pmf_table.deviceData();
+  amrex::Print() << "PMF lookup table: max relative deviation "
+                 << PeleC::prob_parm_host->pmf_table.check() << ", at most "
+                 << PeleC::prob_parm_host->pmf_table.maxSteps()
+                 << " extra steps per lookup" << std::endl;
 }
 
 void
@@ -123,10 +135,14 @@ init_bc()
     // Use host pointers for host call to pmf()
     PeleC::h_prob_parm_device->d_pmf_X = PeleC::prob_parm_host->h_pmf_X.data();
     PeleC::h_prob_parm_device->d_pmf_Y = PeleC::prob_parm_host->h_pmf_Y.data();
+    PeleC::h_prob_parm_device->pmf_table =
+      PeleC::prob_parm_host->pmf_table.hostData();
     pmf(yl, yr, pmf_vals, *PeleC::h_prob_parm_device);
     // Switch back to device pointers
     PeleC::h_prob_parm_device->d_pmf_X = PeleC::prob_parm_host->pmf_X.data();
     PeleC::h_prob_parm_device->d_pmf_Y = PeleC::prob_parm_host->pmf_Y.data();
+    PeleC::h_prob_parm_device->pmf_table =
+      PeleC::prob_parm_host->pmf_table.deviceData();
     amrex::Real mysum = 0.0;
     for (int n = 0; n < NUM_SPECIES; n++) {
       molefrac[n] = amrex::max<amrex::Real>(0.0, pmf_vals[3 + n]);
@@ -0,0 +1,180 @@
+/** \file test-pltcompress.cpp
+ *
+ *  Tests the error-bounded codec of the compressed plotfiles
+ */
+
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "AMReX_FileSystem.H"
+#include "AMReX_MultiFab.H"
+#include "AMReX_ParallelDescriptor.H"
+#include "PltCompress.H"
+
+namespace pelec_tests {
+
+namespace {
+
+// Encode and decode n values, returning the decoded values
+std::vector<amrex::Real>
+round_trip(
+  const std::vector<amrex::Real>& v,
+  const double eb,
+  std::vector<unsigned char>& buf)
+{
+  const auto n = static_cast<amrex::Long>(v.size());
+  pele::pelec::encodeCompressedStream(v.data(), n, eb, buf);
+  std::vector<amrex::Real> d(v.size(), 0.0);
+  pele::pelec::decodeCompressedStream(buf.data(), n, d.data());
+  return d;
+}
+
+amrex::Real
+max_error(
+  const std::vector<amrex::Real>& a, const std::vector<amrex::Real>& b)
+{
+  amrex::Real err = 0.0;
+  for (size_t i = 0; i < a.size(); i++) {
+    err = amrex::max(err, std::abs(a[i] - b[i]));
+  }
+  return err;
+}
+
+} // namespace
+
+TEST(PltCompress, RandomRoundTrip)
+{
+  std::mt19937 gen(42);
+  std::uniform_real_distribution<amrex::Real> dist(-1.0e3, 1.0e3);
+  std::vector<amrex::Real> v(1024);
+  for (auto& x : v) {
+    x = dist(gen);
+  }
+  for (const double eb : {1.0e-1, 1.0e-4, 1.0e-8}) {
+    std::vector<unsigned char> buf;
+    const auto d = round_trip(v, eb, buf);
+    EXPECT_LE(max_error(v, d), eb);
+    EXPECT_LT(buf.size(), v.size() * sizeof(double));
+  }
+}
+
+TEST(PltCompress, ConstantBlock)
+{
+  // A width of 0: only the width and the block minimum are stored
+  const std::vector<amrex::Real> v(64, 2.5);
+  std::vector<unsigned char> buf;
+  const auto d = round_trip(v, 1.0e-8, buf);
+  ASSERT_EQ(buf.size(), 2 * sizeof(double) + 1);
+  EXPECT_EQ(buf[sizeof(double)], 0);
+  for (const auto x : d) {
+    EXPECT_EQ(x, 2.5);
+  }
+}
+
+TEST(PltCompress, NonFiniteRaw)
+{
+  // The first block is quantized, the second is stored raw
+  std::vector<amrex::Real> v(128);
+  for (int i = 0; i < 128; i++) {
+    v[i] = std::sin(0.1 * i);
+  }
+  v[70] = std::numeric_limits<amrex::Real>::quiet_NaN();
+  v[90] = std::numeric_limits<amrex::Real>::infinity();
+  v[91] = -std::numeric_limits<amrex::Real>::infinity();
+  const double eb = 1.0e-6;
+
+  std::vector<unsigned char> first;
+  const std::vector<amrex::Real> v0(v.begin(), v.begin() + 64);
+  round_trip(v0, eb, first);
+
+  std::vector<unsigned char> buf;
+  const auto d = round_trip(v, eb, buf);
+  ASSERT_EQ(buf.size(), first.size() + 1 + 64 * sizeof(double));
+  EXPECT_EQ(buf[first.size()], 0xFF);
+  for (int i = 0; i < 64; i++) {
+    EXPECT_LE(std::abs(d[i] - v[i]), eb);
+  }
+  for (int i = 64; i < 128; i++) {
+    if (std::isnan(v[i])) {
+      EXPECT_TRUE(std::isnan(d[i]));
+    } else {
+      EXPECT_EQ(d[i], v[i]);
+    }
+  }
+}
+
+TEST(PltCompress, PartialBlock)
+{
+  for (const int n : {5, 64 * 2 + 5}) {
+    std::vector<amrex::Real> v(n);
+    for (int i = 0; i < n; i++) {
+      v[i] = 1.0e5 + std::cos(0.3 * i);
+    }
+    const double eb = 1.0e-7;
+    std::vector<unsigned char> buf;
+    const auto d = round_trip(v, eb, buf);
+    EXPECT_LE(max_error(v, d), eb);
+  }
+}
+
+TEST(PltCompress, MultiBoxPlotfile)
+{
+  // Boxes of uneven sizes, so that most FABs end with a partial block,
+  // read back on a different box array
+  const amrex::Box domain(
+    amrex::IntVect(AMREX_D_DECL(0, 0, 0)),
+    amrex::IntVect(AMREX_D_DECL(19, 11, 9)));
+  const amrex::RealBox rb(
+    {AMREX_D_DECL(0.0, 0.0, 0.0)}, {AMREX_D_DECL(1.0, 1.0, 1.0)});
+  const amrex::Array<int, AMREX_SPACEDIM> is_per{AMREX_D_DECL(1, 1, 1)};
+  const amrex::Geometry geom(domain, rb, 0, is_per);
+
+  amrex::BoxArray ba(domain);
+  ba.maxSize(7);
+  const amrex::DistributionMapping dm(ba);
+  const int nvars = 2;
+  amrex::MultiFab mf(ba, dm, nvars, 0);
+  auto const& arrs = mf.arrays();
+  amrex::ParallelFor(
+    mf, [=] AMREX_GPU_DEVICE(int nbx, int i, int j, int k) noexcept {
+      arrs[nbx](i, j, k, 0) = std::sin(0.3 * i) * std::cos(0.2 * j) + 0.1 * k;
+      arrs[nbx](i, j, k, 1) = 3.0;
+    });
+  amrex::Gpu::synchronize();
+
+  const std::string pltfile = "pcz_test_plt";
+  const amrex::Vector<std::string> varnames = {"smooth", "constant"};
+  amrex::Vector<pele::pelec::PltCompressTol> tols(nvars);
+  tols[0] = {1.0e-6, true};
+  tols[1] = {1.0e-10, false};
+  pele::pelec::writeCompressedPlotfile(
+    pltfile, 1, {&mf}, varnames, {geom}, 0.0, {0}, {}, tols, false);
+  amrex::ParallelDescriptor::Barrier();
+
+  ASSERT_TRUE(pele::pelec::CompressedPltFile::isCompressed(pltfile));
+  pele::pelec::CompressedPltFile plt(pltfile);
+  ASSERT_EQ(static_cast<int>(plt.getVariableList().size()), nvars);
+  EXPECT_EQ(plt.getVariableList()[0], "smooth");
+
+  amrex::BoxArray ba_out(domain);
+  ba_out.maxSize(16);
+  amrex::MultiFab out(ba_out, amrex::DistributionMapping(ba_out), nvars, 0);
+  plt.fillPatchFromPlt(0, geom, 0, 0, nvars, out);
+
+  amrex::MultiFab ref(ba_out, out.DistributionMap(), nvars, 0);
+  ref.ParallelCopy(mf, 0, 0, nvars);
+  const amrex::Real range = mf.max(0) - mf.min(0);
+  amrex::MultiFab::Subtract(out, ref, 0, 0, nvars, 0);
+  EXPECT_LE(out.norminf(0), 1.0e-6 * range);
+  EXPECT_LE(out.norminf(1), 1.0e-10);
+
+  amrex::ParallelDescriptor::Barrier();
+  if (amrex::ParallelDescriptor::IOProcessor()) {
+    amrex::FileSystem::RemoveAll(pltfile);
+  }
+}
+
+} // namespace pelec_tests
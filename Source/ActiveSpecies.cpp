@@ -0,0 +1,134 @@
+#include "ActiveSpecies.H"
+#include "IndexDefines.H"
+
+namespace pele::pelec {
+
+void
+ActiveSpecies::update(
+  const amrex::MultiFab& S,
+  const amrex::Geometry& geom,
+  int level,
+  int ngrow,
+  amrex::Real threshold)
+{
+  BL_PROFILE("ActiveSpecies::update()");
+
+  const amrex::BoxArray& ba = S.boxArray();
+  m_lists.define(ba, S.DistributionMap());
+
+  // Largest mass fraction of each species in each local box
+  amrex::Gpu::DeviceVector<amrex::Real> d_ymax(
+    static_cast<size_t>(S.local_size()) * NUM_SPECIES, 0.0);
+  amrex::Real* ymax = d_ymax.data();
+#ifdef AMREX_USE_OMP
+#pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
+#endif
+  for (amrex::MFIter mfi(S); mfi.isValid(); ++mfi) {
+    auto const& s = S.const_array(mfi);
+    amrex::Real* ym = ymax + mfi.LocalIndex() * NUM_SPECIES;
+    amrex::ParallelFor(
+      mfi.validbox(), NUM_SPECIES,
+      [=] AMREX_GPU_DEVICE(int i, int j, int k, int n) noexcept {
+        amrex::Gpu::Atomic::Max(
+          ym + n, std::abs(s(i, j, k, UFS + n) / s(i, j, k, URHO)));
+      });
+  }
+  amrex::Vector<amrex::Real> h_ymax(d_ymax.size());
+  amrex::Gpu::copy(
+    amrex::Gpu::deviceToHost, d_ymax.begin(), d_ymax.end(), h_ymax.begin());
+
+  // Species present in every box, as bits set by the owner of the box
+  constexpr int nbits = 32;
+  constexpr int nwords = (NUM_SPECIES + nbits - 1) / nbits;
+  amrex::Vector<amrex::Long> present(ba.size() * nwords, 0);
+  for (amrex::MFIter mfi(S); mfi.isValid(); ++mfi) {
+    const int li = mfi.LocalIndex();
+    for (int ns = 0; ns < NUM_SPECIES; ns++) {
+      if (h_ymax[li * NUM_SPECIES + ns] > threshold) {
+        const int w = mfi.index() * nwords + ns / nbits;
+        present[w] |= amrex::Long(1) << (ns % nbits);
+      }
+    }
+  }
+  amrex::ParallelDescriptor::ReduceLongSum(
+    present.data(), static_cast<int>(present.size()));
+
+  const amrex::Box& domain = geom.Domain();
+  const auto pshifts = geom.periodicity().shiftIntVect();
+  for (amrex::MFIter mfi(S); mfi.isValid(); ++mfi) {
+    const amrex::Box gbx = amrex::grow(mfi.validbox(), ngrow);
+
+    // Physical boundaries may bring in any species
+    bool all = false;
+    for (int dir = 0; dir < AMREX_SPACEDIM; dir++) {
+      if (
+        !geom.isPeriodic(dir) && ((gbx.smallEnd(dir) < domain.smallEnd(dir)) ||
+                                  (gbx.bigEnd(dir) > domain.bigEnd(dir)))) {
+        all = true;
+      }
+    }
+
+    // So may the coarser level around this one, otherwise the species
+    // are those of the neighboring boxes
+    amrex::Long words[nwords] = {0};
+    for (const auto& iv : pshifts) {
+      if (all) {
+        break;
+      }
+      amrex::Box sbx = gbx + iv;
+      sbx &= domain;
+      if (!sbx.ok()) {
+        continue;
+      }
+      if ((level > 0) && !ba.contains(sbx)) {
+        all = true;
+        break;
+      }
+      for (const auto& isect : ba.intersections(sbx)) {
+        for (int w = 0; w < nwords; w++) {
+          words[w] |= present[isect.first * nwords + w];
+        }
+      }
+    }
+
+    SpeciesList& l = m_lists[mfi];
+    l.n = 0;
+    for (int ns = 0; ns < NUM_SPECIES; ns++) {
+      if (all || ((words[ns / nbits] >> (ns % nbits)) & 1) != 0) {
+        l.idx[l.n++] = ns;
+      }
+    }
+  }
+  m_valid = true;
+}
+
+bool
+ActiveSpecies::isValidFor(const amrex::FabArrayBase& mf) const
+{
+  return m_valid && (mf.boxArray() == m_lists.boxArray()) &&
+         (mf.DistributionMap() == m_lists.DistributionMap());
+}
+
+void
+ActiveSpecies::stats(amrex::Real& mean, int& nmin, int& nmax) const
+{
+  amrex::Real nsum = 0.0;
+  amrex::Long ncells = 0;
+  nmin = NUM_SPECIES;
+  nmax = 0;
+  for (amrex::MFIter mfi(m_lists); mfi.isValid(); ++mfi) {
+    const int n = m_lists[mfi].n;
+    const amrex::Long npts = mfi.validbox().numPts();
+    nsum += static_cast<amrex::Real>(n * npts);
+    ncells += npts;
+    nmin = amrex::min(nmin, n);
+    nmax = amrex::max(nmax, n);
+  }
+  amrex::ParallelDescriptor::ReduceRealSum(nsum);
+  amrex::ParallelDescriptor::ReduceLongSum(ncells);
+  amrex::ParallelDescriptor::ReduceIntMin(nmin);
+  amrex::ParallelDescriptor::ReduceIntMax(nmax);
+  mean = (ncells > 0) ? nsum / static_cast<amrex::Real>(ncells) : 0.0;
+}
+
+} // namespace pele::pelec
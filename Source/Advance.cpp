@@ -2,6 +2,9 @@
 
 #include "PeleC.H"
 #include "IndexDefines.H"
+#include "PerfCounters.H"
+#include "EntropyProd.H"
+#include "GradCache.H"
 
 #ifdef PELEC_USE_SPRAY
 #include "SprayParticles.H"
@@ -22,6 +25,14 @@ PeleC::advance(
 
   BL_PROFILE("PeleC::advance()");
 
+  // Release the derived gradients of the state being advanced
+  pele::pelec::GradientCache::level(level).clear();
+
+  // Count the temperature Newton iterations of this step only, not those
+  // of the initialization or of the regrids
+  temp_newton_iters = 0;
+  temp_newton_cells = 0;
+
   int finest_level = parent->finestLevel();
 
   if (level < finest_level && do_reflux) {
@@ -39,6 +50,10 @@ PeleC::advance(
     dt_new = do_sdc_advance(time, dt, amr_iteration, amr_ncycle);
   }
 
+  if (do_entropy_state) {
+    finalize_entropy_state();
+  }
+
   return dt_new;
 }
 
@@ -52,8 +67,11 @@ PeleC::do_mol_advance(
   // if (src_list.size() > 0) amrex::Abort("Have not integrated other sources
   // into MOL advance yet");
 
+  // Running statistics and entropy production only live at the new time
   for (int i = 0; i < num_state_type; ++i) {
-    if ((i != Reactions_Type) || (!do_react)) {
+    if (
+      ((i != Reactions_Type) || (!do_react)) && (i != Stats_Type) &&
+      (i != Entropy_Type)) {
       state[i].allocOldData();
       state[i].swapTimeLevels(dt);
     }
@@ -95,9 +113,8 @@ PeleC::do_mol_advance(
   AMREX_ASSERT(Sborder.nGrow() >= nGrow_FP_border);
 #endif
 
-  FillPatcherFill(Sborder, 0, NVAR, nGrow_FP_border, time, State_Type, 0);
   amrex::Real flux_factor = 0;
-  getMOLSrcTerm(Sborder, molSrc, time, dt, flux_factor);
+  fill_sborder_mol_src(time, nGrow_FP_border, molSrc, time, dt, flux_factor);
 
   // Build other (non-diffusion) sources at t_old
   for (int n = 0; n < src_list.size(); ++n) {
@@ -106,8 +123,7 @@ PeleC::do_mol_advance(
         src_list[n], time, dt, amr_iteration, amr_ncycle, 0, 0);
 
       // add sources to molsrc
-      amrex::MultiFab::Saxpy(
-        molSrc, 1.0, *old_sources[src_list[n]], 0, 0, NVAR, 0);
+      old_sources[src_list[n]]->saxpy(molSrc, 1.0, 0);
     }
   }
 
@@ -131,9 +147,9 @@ PeleC::do_mol_advance(
     amrex::Print() << "... Computing MOL source term at t^{n+1} " << std::endl;
   }
 
-  FillPatcherFill(Sborder, 0, NVAR, nGrow_FP_border, time + dt, State_Type, 0);
   flux_factor = mol_iters > 1 ? 0 : 1;
-  getMOLSrcTerm(Sborder, molSrc, time, dt, flux_factor);
+  fill_sborder_mol_src(
+    time + dt, nGrow_FP_border, molSrc, time, dt, flux_factor);
 
   // Build other (non-diffusion) sources at t_new
   for (int n = 0; n < src_list.size(); ++n) {
@@ -142,8 +158,7 @@ PeleC::do_mol_advance(
         src_list[n], time + dt, dt, amr_iteration, amr_ncycle, 0, 0);
 
       // add sources to molsrc
-      amrex::MultiFab::Saxpy(
-        molSrc, 1.0, *new_sources[src_list[n]], 0, 0, NVAR, 0);
+      new_sources[src_list[n]]->saxpy(molSrc, 1.0, 0);
     }
   }
 
@@ -178,10 +193,9 @@ PeleC::do_mol_advance(
                        << mol_iter << " of " << mol_iters << ")" << std::endl;
       }
 
-      FillPatcherFill(
-        Sborder, 0, NVAR, nGrow_FP_border, time + dt, State_Type, 0);
       flux_factor = mol_iter == mol_iters ? 1 : 0;
-      getMOLSrcTerm(Sborder, molSrc_new, time, dt, flux_factor);
+      fill_sborder_mol_src(
+        time + dt, nGrow_FP_border, molSrc_new, time, dt, flux_factor);
 
       // F_{AD} = (1/2)(molSrc_old + molSrc_new)
       amrex::MultiFab::LinComb(
@@ -276,7 +290,7 @@ PeleC::do_sdc_iteration(
 #endif
 
   if (fill_Sborder) {
-    FillPatcherFill(Sborder, 0, NVAR, nGrow_FP_border, time, State_Type, 0);
+    fill_sborder(time, nGrow_FP_border);
   }
 
   if (sub_iteration == 0) {
@@ -300,13 +314,14 @@ PeleC::do_sdc_iteration(
         !do_mol); // Currently this combo only managed through MOL integrator
       amrex::Real flux_factor_old = 0.5;
 
-      getMOLSrcTerm(Sborder, *old_sources[diff_src], time, dt, flux_factor_old);
+      getMOLSrcTerm(
+        Sborder, old_sources[diff_src]->fill(), time, dt, flux_factor_old);
+      old_sources[diff_src]->commit();
     }
 
     // Initialize sources at t_new by copying from t_old
     for (int n = 0; n < src_list.size(); ++n) {
-      amrex::MultiFab::Copy(
-        *new_sources[src_list[n]], *old_sources[src_list[n]], 0, 0, NVAR, 0);
+      new_sources[src_list[n]]->copy(*old_sources[src_list[n]]);
     }
   }
 
@@ -324,12 +339,9 @@ PeleC::do_sdc_iteration(
 
   // Now update t_new sources (diffusion separate because it requires a fill
   // patch)
-  if (do_diffuse || do_spray_particles) {
-    int nGrowDiff = numGrow();
-    if (do_spray_particles && level > 0) {
-      nGrowDiff = amrex::max(nGrowDiff, nGrow_FP_border);
-    }
-    FillPatcherFill(Sborder, 0, NVAR, nGrowDiff, time + dt, State_Type, 0);
+  int nGrowDiff = numGrow();
+  if (do_spray_particles && level > 0) {
+    nGrowDiff = amrex::max(nGrowDiff, nGrow_FP_border);
   }
   if (do_diffuse) {
     if (verbose != 0) {
@@ -337,7 +349,18 @@ PeleC::do_sdc_iteration(
                      << sub_iteration + 1 << ")" << std::endl;
     }
     amrex::Real flux_factor_new = sub_iteration == sub_ncycle - 1 ? 0.5 : 0;
-    getMOLSrcTerm(Sborder, *new_sources[diff_src], time, dt, flux_factor_new);
+    // The lists of the last step do not see the species entering a box
+    // during this one, rebuild them from the current iterate
+    if (active_species) {
+      active_spec.update(
+        S_new, geom, level, numGrow(), active_species_threshold);
+    }
+    fill_sborder_mol_src(
+      time + dt, nGrowDiff, new_sources[diff_src]->fill(), time, dt,
+      flux_factor_new);
+    new_sources[diff_src]->commit();
+  } else if (do_spray_particles) {
+    fill_sborder(time + dt, nGrowDiff);
   }
 
   // Build other (non-diffusion) sources at t_new
@@ -373,10 +396,8 @@ PeleC::construct_Snew(
 
   amrex::MultiFab::Copy(S_new, S_old, 0, 0, NVAR, ng);
   for (int n = 0; n < src_list.size(); ++n) {
-    amrex::MultiFab::Saxpy(
-      S_new, 0.5 * dt, *new_sources[src_list[n]], 0, 0, NVAR, ng);
-    amrex::MultiFab::Saxpy(
-      S_new, 0.5 * dt, *old_sources[src_list[n]], 0, 0, NVAR, ng);
+    new_sources[src_list[n]]->saxpy(S_new, 0.5 * dt, ng);
+    old_sources[src_list[n]]->saxpy(S_new, 0.5 * dt, ng);
   }
   if (do_hydro) {
     amrex::MultiFab::Saxpy(S_new, dt, hydro_source, 0, 0, NVAR, ng);
@@ -432,9 +453,12 @@ PeleC::initialize_sdc_advance(
 {
   BL_PROFILE("PeleC::initialize_sdc_advance()");
 
+  // Running statistics and entropy production only live at the new time
   for (int i = 0; i < num_state_type; ++i) {
-    state[i].allocOldData();
-    state[i].swapTimeLevels(dt);
+    if ((i != Stats_Type) && (i != Entropy_Type)) {
+      state[i].allocOldData();
+      state[i].swapTimeLevels(dt);
+    }
   }
 
   if (do_react) {
@@ -466,3 +490,148 @@ PeleC::finalize_sdc_advance(
     }
   }
 }
+
+void
+PeleC::fill_sborder(amrex::Real time, int nGrow)
+{
+  BL_PROFILE("PeleC::fill_sborder()");
+  const amrex::Long ncells = grids.numPts();
+  pele::pelec::PerfTimer perf_timer(
+    level, pele::pelec::perf_fillpatch, ncells,
+    ncells * NVAR * static_cast<amrex::Long>(sizeof(amrex::Real)));
+  FillPatcherFill(Sborder, 0, NVAR, nGrow, time, State_Type, 0);
+}
+
+void
+PeleC::fill_sborder_mol_src(
+  amrex::Real fill_time,
+  int nGrow,
+  amrex::MultiFab& MOLSrcTerm,
+  amrex::Real time,
+  amrex::Real dt,
+  amrex::Real flux_factor)
+{
+  BL_PROFILE("PeleC::fill_sborder_mol_src()");
+
+  // The flux registers take the fluxes of whole tiles, so an evaluation
+  // adding to them is not split
+  const bool reflux_now =
+    do_reflux && (flux_factor != 0) &&
+    ((level > 0) || (level < parent->finestLevel()));
+  amrex::Vector<amrex::MultiFab*> smf;
+  amrex::Vector<amrex::Real> stime;
+  if (fillpatch_overlap && !reflux_now) {
+    state[State_Type].getData(smf, stime, fill_time);
+  }
+  if (smf.size() != 1) {
+    fill_sborder(fill_time, nGrow);
+    getMOLSrcTerm(Sborder, MOLSrcTerm, time, dt, flux_factor);
+    return;
+  }
+
+  const amrex::Long ncells = grids.numPts();
+  const amrex::Real t_start = pele::pelec::PerfCounters::wtime();
+
+  // Same as FillPatchSingleLevel, with the interior of the tiles computed
+  // between posting and completing the exchange. On finer levels, the ghost
+  // cells are first interpolated from the coarser level (blocking), then
+  // those covered by the level are overwritten by the exchange.
+  if (level > 0) {
+    FillCoarsePatch(Sborder, 0, fill_time, State_Type, 0, NVAR, nGrow);
+  }
+  amrex::MultiFab::Copy(Sborder, *smf[0], 0, 0, NVAR, 0);
+  Sborder.FillBoundary_nowait(
+    0, NVAR, amrex::IntVect(nGrow), geom.periodicity());
+  const amrex::Real t_posted = pele::pelec::PerfCounters::wtime();
+
+  getMOLSrcTerm(
+    Sborder, MOLSrcTerm, time, dt, flux_factor, mol_tiles_interior);
+  const amrex::Real t_interior = pele::pelec::PerfCounters::wtime();
+
+  Sborder.FillBoundary_finish();
+  amrex::StateDataPhysBCFunct physbc(state[State_Type], 0, geom);
+  physbc(Sborder, 0, NVAR, amrex::IntVect(nGrow), fill_time, 0);
+  const amrex::Real t_filled = pele::pelec::PerfCounters::wtime();
+
+  // Only the exposed part of the fill is charged to it
+  pele::pelec::PerfCounters::add(
+    level, pele::pelec::perf_fillpatch,
+    (t_posted - t_start) + (t_filled - t_interior), ncells,
+    ncells * NVAR * static_cast<amrex::Long>(sizeof(amrex::Real)));
+
+  getMOLSrcTerm(
+    Sborder, MOLSrcTerm, time, dt, flux_factor, mol_tiles_boundary);
+
+  if (verbose != 0) {
+    // Fraction of the cells computed while the exchange was in flight
+    amrex::Long overlapped[2] = {0, 0};
+    for (amrex::MFIter mfi(MOLSrcTerm, amrex::TilingIfNotGPU()); mfi.isValid();
+         ++mfi) {
+      const amrex::Box& vbox = mfi.tilebox();
+      for (const amrex::Box& bx : pc_mol_tile_parts(
+             vbox, mfi.validbox(), numGrow(), mol_tiles_interior)) {
+        overlapped[0] += bx.numPts();
+      }
+      overlapped[1] += vbox.numPts();
+    }
+    amrex::Real t_wait = t_filled - t_interior;
+    amrex::ParallelDescriptor::ReduceLongSum(overlapped, 2);
+    amrex::ParallelDescriptor::ReduceRealMax(t_wait);
+    amrex::Print() << "... FillPatch overlap at level " << level << ": "
+                   << 100.0 * static_cast<amrex::Real>(overlapped[0]) /
+                        static_cast<amrex::Real>(overlapped[1])
+                   << "% of the cells computed during the ghost exchange, "
+                   << t_wait << " s exposed wait" << std::endl;
+  }
+}
+
+void
+PeleC::finalize_entropy_state()
+{
+  BL_PROFILE("PeleC::finalize_entropy_state()");
+
+  // Entropy_Type is not swapped in the advance, keep its time in sync
+  state[Entropy_Type].setNewTimeLevel(state[State_Type].curTime());
+
+  amrex::MultiFab& Ent = get_new_data(Entropy_Type);
+#if NUM_SPECIES > 1
+  const amrex::MultiFab& S_new = get_new_data(State_Type);
+  const amrex::MultiFab& I_R = get_new_data(Reactions_Type);
+  auto const& sarrs = S_new.const_arrays();
+  auto const& rarrs = I_R.const_arrays();
+  auto const& earrs = Ent.arrays();
+  const bool chem = do_react;
+  const auto thermo = pele::pelec::ThermoTable::view();
+  amrex::ParallelFor(
+    Ent, [=] AMREX_GPU_DEVICE(int nbx, int i, int j, int k) noexcept {
+      amrex::Real s_chem = 0.0;
+      if (chem) {
+        auto eos = pele::physics::PhysicsType::eos();
+        amrex::Real imw[NUM_SPECIES];
+        eos.inv_molecular_weight(imw);
+        const amrex::Real rho = sarrs[nbx](i, j, k, URHO);
+        const amrex::Real rhoInv = 1.0 / rho;
+        amrex::Real massfrac[NUM_SPECIES];
+        for (int n = 0; n < NUM_SPECIES; n++) {
+          massfrac[n] = sarrs[nbx](i, j, k, UFS + n) * rhoInv;
+        }
+        amrex::Real mu_RT[NUM_SPECIES];
+        pc_chem_potential_RT(
+          rho, sarrs[nbx](i, j, k, UTEMP), massfrac, imw, thermo, mu_RT);
+        for (int n = 0; n < NUM_SPECIES; n++) {
+          s_chem -= rarrs[nbx](i, j, k, n) * imw[n] * mu_RT[n];
+        }
+        s_chem *= pele::physics::Constants::RU;
+      }
+      auto const& ent = earrs[nbx];
+      ent(i, j, k, ent_chem) = s_chem;
+      ent(i, j, k, ent_total) = ent(i, j, k, ent_visc) +
+                                ent(i, j, k, ent_heat) +
+                                ent(i, j, k, ent_diff) + s_chem;
+    });
+  amrex::Gpu::streamSynchronize();
+#else
+  Ent.setVal(0.0);
+#endif
+  entropy_state_valid = true;
+}
@@ -1,3 +1,7 @@
+#include <map>
+#include <mutex>
+#include <tuple>
+
 #include <AMReX_FArrayBox.H>
 #include <AMReX_Geometry.H>
 #include <AMReX_PhysBCFunct.H>
@@ -5,151 +9,123 @@
 #include "PeleC.H"
 #include "prob.H"
 
-struct PCHypFillExtDir
-{
-  ProbParmDevice const* lprobparm;
-  bool m_do_turb_inflow{false};
+namespace {
 
-  AMREX_GPU_HOST
-  constexpr explicit PCHypFillExtDir(
-    const ProbParmDevice* d_prob_parm, const bool do_turb_inflow)
-    : lprobparm(d_prob_parm), m_do_turb_inflow(do_turb_inflow)
-  {
+// Ghost cells of bx beyond face ori of the domain, including the edges and
+// corners shared with the other faces
+amrex::Box
+pc_bc_slab(
+  const amrex::Box& bx, const amrex::Box& domain, const amrex::Orientation ori)
+{
+  const int dir = ori.coordDir();
+  amrex::Box slab(bx);
+  if (ori.isLow()) {
+    slab.setBig(dir, amrex::min(bx.bigEnd(dir), domain.smallEnd(dir) - 1));
+  } else {
+    slab.setSmall(dir, amrex::max(bx.smallEnd(dir), domain.bigEnd(dir) + 1));
   }
+  return slab;
+}
 
-  AMREX_GPU_DEVICE
-  void operator()(
-    const amrex::IntVect& iv,
-    amrex::Array4<amrex::Real> const& dest,
-    const int /*dcomp*/,
-    const int /*numcomp*/,
-    amrex::GeometryData const& geom,
-    const amrex::Real time,
-    const amrex::BCRec* bcr,
-    const int /*bcomp*/,
-    const int /*orig_comp*/) const
-  {
-    const int* domlo = geom.Domain().loVect();
-    const int* domhi = geom.Domain().hiVect();
-    const amrex::Real* prob_lo = geom.ProbLo();
-    const amrex::Real* dx = geom.CellSize();
+// Problem bcnormal on all the cells of the ghost slab of one face. With
+// turbulent inflow, the first ghost layer already holds the fluctuations,
+// which are passed in as the initial exterior state.
+void
+pc_bcnormal_face(
+  const amrex::Box& slab,
+  const amrex::Orientation ori,
+  amrex::Array4<amrex::Real> const& dest,
+  amrex::GeometryData const& geomdata,
+  const amrex::Real time,
+  const bool do_turb_inflow,
+  ProbParmDevice const* lprobparm)
+{
+  const int idir = ori.coordDir();
+  const int sgn = ori.isLow() ? +1 : -1;
+  const int face = ori.isLow() ? geomdata.Domain().smallEnd(idir)
+                               : geomdata.Domain().bigEnd(idir);
+  const int layer1 = face - sgn;
+  amrex::ParallelFor(slab, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
+    const amrex::IntVect iv(AMREX_D_DECL(i, j, k));
+    const amrex::Real* prob_lo = geomdata.ProbLo();
+    const amrex::Real* dx = geomdata.CellSize();
     const amrex::Real x[AMREX_SPACEDIM] = {AMREX_D_DECL(
       prob_lo[0] + static_cast<amrex::Real>(iv[0] + 0.5) * dx[0],
       prob_lo[1] + static_cast<amrex::Real>(iv[1] + 0.5) * dx[1],
       prob_lo[2] + static_cast<amrex::Real>(iv[2] + 0.5) * dx[2])};
 
-    const int* bc = bcr->data();
-
+    amrex::IntVect loc(iv);
+    loc[idir] = face;
     amrex::Real s_int[NVAR] = {0.0};
     amrex::Real s_ext[NVAR] = {0.0};
-
-    // xlo and xhi
-    int idir = 0;
-    if ((bc[idir] == amrex::BCType::ext_dir) && (iv[idir] < domlo[idir])) {
-      const amrex::IntVect loc(AMREX_D_DECL(domlo[idir], iv[1], iv[2]));
-      for (int n = 0; n < NVAR; n++) {
-        s_int[n] = dest(loc, n);
-      }
-      if (m_do_turb_inflow && (iv[idir] == domlo[idir] - 1)) {
-        for (int n = 0; n < NVAR; n++) {
-          s_ext[n] = dest(iv, n);
-        }
-      }
-      bcnormal(x, s_int, s_ext, idir, +1, time, geom, *lprobparm);
-      for (int n = 0; n < NVAR; n++) {
-        dest(iv, n) = s_ext[n];
-      }
-    } else if (
-      (bc[idir + AMREX_SPACEDIM] == amrex::BCType::ext_dir) &&
-      (iv[idir] > domhi[idir])) {
-      const amrex::IntVect loc(AMREX_D_DECL(domhi[idir], iv[1], iv[2]));
-      for (int n = 0; n < NVAR; n++) {
-        s_int[n] = dest(loc, n);
-      }
-      if (m_do_turb_inflow && (iv[idir] == domlo[idir] - 1)) {
-        for (int n = 0; n < NVAR; n++) {
-          s_ext[n] = dest(iv, n);
-        }
-      }
-      bcnormal(x, s_int, s_ext, idir, -1, time, geom, *lprobparm);
-      for (int n = 0; n < NVAR; n++) {
-        dest(iv, n) = s_ext[n];
-      }
+    for (int n = 0; n < NVAR; n++) {
+      s_int[n] = dest(loc, n);
     }
-#if AMREX_SPACEDIM > 1
-    // ylo and yhi
-    idir = 1;
-    if ((bc[idir] == amrex::BCType::ext_dir) && (iv[idir] < domlo[idir])) {
-      const amrex::IntVect loc(AMREX_D_DECL(iv[0], domlo[idir], iv[2]));
+    if (do_turb_inflow && (iv[idir] == layer1)) {
       for (int n = 0; n < NVAR; n++) {
-        s_int[n] = dest(loc, n);
-      }
-      if (m_do_turb_inflow && (iv[idir] == domlo[idir] - 1)) {
-        for (int n = 0; n < NVAR; n++) {
-          s_ext[n] = dest(iv, n);
-        }
-      }
-      bcnormal(x, s_int, s_ext, idir, +1, time, geom, *lprobparm);
-      for (int n = 0; n < NVAR; n++) {
-        dest(iv, n) = s_ext[n];
-      }
-    } else if (
-      (bc[idir + AMREX_SPACEDIM] == amrex::BCType::ext_dir) &&
-      (iv[idir] > domhi[idir])) {
-      const amrex::IntVect loc(AMREX_D_DECL(iv[0], domhi[idir], iv[2]));
-      for (int n = 0; n < NVAR; n++) {
-        s_int[n] = dest(loc, n);
-      }
-      if (m_do_turb_inflow && (iv[idir] == domhi[idir] + 1)) {
-        for (int n = 0; n < NVAR; n++) {
-          s_ext[n] = dest(iv, n);
-        }
-      }
-      bcnormal(x, s_int, s_ext, idir, -1, time, geom, *lprobparm);
-      for (int n = 0; n < NVAR; n++) {
-        dest(iv, n) = s_ext[n];
+        s_ext[n] = dest(iv, n);
       }
     }
-#if AMREX_SPACEDIM == 3
-    // zlo and zhi
-    idir = 2;
-    if ((bc[idir] == amrex::BCType::ext_dir) && (iv[idir] < domlo[idir])) {
-      const amrex::IntVect loc(AMREX_D_DECL(iv[0], iv[1], domlo[idir]));
-      for (int n = 0; n < NVAR; n++) {
-        s_int[n] = dest(loc, n);
-      }
-      if (m_do_turb_inflow && (iv[idir] == domhi[idir] + 1)) {
-        for (int n = 0; n < NVAR; n++) {
-          s_ext[n] = dest(iv, n);
-        }
-      }
-      bcnormal(x, s_int, s_ext, idir, +1, time, geom, *lprobparm);
-      for (int n = 0; n < NVAR; n++) {
-        dest(iv, n) = s_ext[n];
-      }
-    } else if (
-      (bc[idir + AMREX_SPACEDIM] == amrex::BCType::ext_dir) &&
-      (iv[idir] > domhi[idir])) {
-      const amrex::IntVect loc(AMREX_D_DECL(iv[0], iv[1], domhi[idir]));
-      for (int n = 0; n < NVAR; n++) {
-        s_int[n] = dest(loc, n);
-      }
-      if (m_do_turb_inflow && (iv[idir] == domhi[idir] + 1)) {
-        for (int n = 0; n < NVAR; n++) {
-          s_ext[n] = dest(iv, n);
-        }
-      }
-      bcnormal(x, s_int, s_ext, idir, -1, time, geom, *lprobparm);
-      for (int n = 0; n < NVAR; n++) {
-        dest(iv, n) = s_ext[n];
-      }
+    bcnormal(x, s_int, s_ext, idir, sgn, time, geomdata, *lprobparm);
+    for (int n = 0; n < NVAR; n++) {
+      dest(iv, n) = s_ext[n];
     }
-#endif
-#endif
+  });
+}
+
+// Ghost states of the faces declared steady (pelec.steady_bc_faces), which
+// only depend on the position: computed on the first fill of a slab and
+// copied afterwards. Keyed by face, domain (i.e. level) and slab.
+class SteadyBCCache
+{
+public:
+  using Key = std::tuple<int, amrex::Box, amrex::Box>;
+
+  // Cached states of the slab, nullptr if not computed yet
+  const amrex::FArrayBox* find(const Key& key)
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const auto it = m_fabs.find(key);
+    return (it != m_fabs.end()) ? &(it->second) : nullptr;
+  }
+
+  void insert(
+    const Key& key,
+    const amrex::Box& slab,
+    amrex::Array4<const amrex::Real> const& src)
+  {
+    amrex::FArrayBox fab(slab, NVAR, amrex::The_Arena());
+    auto const& dst = fab.array();
+    amrex::ParallelFor(
+      slab, NVAR, [=] AMREX_GPU_DEVICE(int i, int j, int k, int n) noexcept {
+        dst(i, j, k, n) = src(i, j, k, n);
+      });
+    amrex::Gpu::streamSynchronize();
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_fabs.emplace(key, std::move(fab));
+  }
+
+  void clear()
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_fabs.clear();
+  }
+
+  static SteadyBCCache& get()
+  {
+    static SteadyBCCache cache;
+    return cache;
   }
+
+private:
+  std::mutex m_mutex;
+  std::map<Key, amrex::FArrayBox> m_fabs;
 };
 
-struct PCReactFillExtDir
+} // namespace
+
+// Only the non Dirichlet BCs, handled by GpuBndryFuncFab itself
+struct PCNullFillExtDir
 {
   AMREX_GPU_DEVICE
   void operator()(
@@ -213,10 +189,61 @@ pc_bcfill_hyp(
     }
   }
 
-  const ProbParmDevice* lprobparm = PeleC::d_prob_parm_device;
-  amrex::GpuBndryFuncFab<PCHypFillExtDir> hyp_bndry_func(
-    PCHypFillExtDir{lprobparm, PeleC::turb_inflow.is_initialized()});
+  // Extrapolation and reflection BCs, then the Dirichlet (problem) BCs one
+  // face at a time, so that bcnormal runs over contiguous ghost slabs
+  amrex::GpuBndryFuncFab<PCNullFillExtDir> hyp_bndry_func(PCNullFillExtDir{});
   hyp_bndry_func(bx, data, dcomp, numcomp, geom, time, bcr, bcomp, scomp);
+
+  const ProbParmDevice* lprobparm = PeleC::d_prob_parm_device;
+  const bool do_turb_inflow = PeleC::turb_inflow.is_initialized();
+  const amrex::Box& domain = geom.Domain();
+  auto const& dest = data.array();
+  // Faces are filled direction by direction, low then high, so that the
+  // edge and corner ghost cells end up with the last direction's values as
+  // with the former per-cell fill
+  for (int dir = 0; dir < AMREX_SPACEDIM; dir++) {
+    if (geom.isPeriodic(dir)) {
+      continue;
+    }
+    for (const auto side :
+         {amrex::Orientation::low, amrex::Orientation::high}) {
+      const amrex::Orientation ori(dir, side);
+      const int bc = ori.isLow() ? bcr[0].lo(dir) : bcr[0].hi(dir);
+      const amrex::Box slab = pc_bc_slab(bx, domain, ori);
+      if ((bc != amrex::BCType::ext_dir) || !slab.ok()) {
+        continue;
+      }
+
+      const bool steady =
+        !do_turb_inflow && ((PeleC::steady_bc_faces & (1 << ori)) != 0);
+      if (!steady) {
+        pc_bcnormal_face(
+          slab, ori, dest, geom.data(), time, do_turb_inflow, lprobparm);
+        continue;
+      }
+
+      auto& cache = SteadyBCCache::get();
+      const SteadyBCCache::Key key{static_cast<int>(ori), domain, slab};
+      if (const amrex::FArrayBox* fab = cache.find(key)) {
+        auto const& src = fab->const_array();
+        amrex::ParallelFor(
+          slab, NVAR,
+          [=] AMREX_GPU_DEVICE(int i, int j, int k, int n) noexcept {
+            dest(i, j, k, n) = src(i, j, k, n);
+          });
+      } else {
+        pc_bcnormal_face(
+          slab, ori, dest, geom.data(), time, false, lprobparm);
+        cache.insert(key, slab, data.const_array());
+      }
+    }
+  }
+}
+
+void
+pc_bcfill_clear_cache()
+{
+  SteadyBCCache::get().clear();
 }
 
 void
@@ -231,8 +258,8 @@ pc_reactfill_hyp(
   const int bcomp,
   const int scomp)
 {
-  amrex::GpuBndryFuncFab<PCReactFillExtDir> react_bndry_func(
-    PCReactFillExtDir{});
+  amrex::GpuBndryFuncFab<PCNullFillExtDir> react_bndry_func(
+    PCNullFillExtDir{});
   react_bndry_func(bx, data, dcomp, numcomp, geom, time, bcr, bcomp, scomp);
 }
 
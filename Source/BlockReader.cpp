@@ -0,0 +1,157 @@
+#include <cstring>
+
+#include <AMReX.H>
+#include <AMReX_Loop.H>
+
+#include "BlockReader.H"
+
+#if defined(__unix__) || defined(__APPLE__)
+#define PELEC_BLOCKREADER_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace pele::pelec {
+
+BlockReader::BlockReader(
+  const std::string& fname, const amrex::IntVect& n, int ncol, bool use_mmap)
+  : m_fname(fname),
+    m_domain(amrex::IntVect::TheZeroVector(), n - 1),
+    m_ncol(ncol)
+{
+  const auto expected = static_cast<std::size_t>(m_domain.numPts()) *
+                        static_cast<std::size_t>(m_ncol) * sizeof(double);
+
+#ifdef PELEC_BLOCKREADER_MMAP
+  if (use_mmap) {
+    const int fd = ::open(m_fname.c_str(), O_RDONLY);
+    if (fd < 0) {
+      amrex::Abort("BlockReader: unable to open input file " + m_fname);
+    }
+    struct stat st;
+    if (::fstat(fd, &st) == 0) {
+      m_size = static_cast<std::size_t>(st.st_size);
+    }
+    if (m_size >= expected) {
+      void* map = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (map != MAP_FAILED) {
+        m_map = map;
+      }
+    }
+    ::close(fd);
+  }
+#else
+  amrex::ignore_unused(use_mmap);
+#endif
+
+  if (m_map == nullptr) {
+    m_file.open(m_fname, std::ios::in | std::ios::binary);
+    if (!m_file.is_open()) {
+      amrex::Abort("BlockReader: unable to open input file " + m_fname);
+    }
+    m_file.seekg(0, std::ios::end);
+    m_size = static_cast<std::size_t>(m_file.tellg());
+    m_file.seekg(0, std::ios::beg);
+  }
+
+  if (m_size < expected) {
+    amrex::Abort(
+      "BlockReader: input file " + m_fname + " holds " +
+      std::to_string(m_size) + " bytes, expected at least " +
+      std::to_string(expected));
+  }
+}
+
+BlockReader::~BlockReader()
+{
+#ifdef PELEC_BLOCKREADER_MMAP
+  if (m_map != nullptr) {
+    ::munmap(m_map, m_size);
+  }
+#endif
+}
+
+void
+BlockReader::readRecords(amrex::Long first, amrex::Long count, double* buf)
+{
+  const auto offset = static_cast<std::size_t>(first) * m_ncol * sizeof(double);
+  const auto nbytes = static_cast<std::size_t>(count) * m_ncol * sizeof(double);
+  if (m_map != nullptr) {
+    std::memcpy(buf, static_cast<const char*>(m_map) + offset, nbytes);
+  } else {
+    m_file.seekg(static_cast<std::streamoff>(offset), std::ios::beg);
+    m_file.read(reinterpret_cast<char*>(buf), nbytes);
+    if (!m_file) {
+      amrex::Abort("BlockReader: read failed in " + m_fname);
+    }
+  }
+  m_bytes_read += static_cast<amrex::Long>(nbytes);
+}
+
+void
+BlockReader::read(
+  const amrex::Box& blk, int comp, int ncomp, amrex::Vector<double>& data)
+{
+  AMREX_ALWAYS_ASSERT(comp >= 0 && comp + ncomp <= m_ncol);
+
+  const amrex::Long npts = blk.numPts();
+  data.resize(npts * ncomp);
+  if (npts == 0) {
+    return;
+  }
+
+  const amrex::IntVect n = m_domain.length();
+  const auto wrap = [](int i, int len) { return ((i % len) + len) % len; };
+
+  // Loop over the rows of blk along the first index, each row is made of at
+  // most a few runs of consecutive records in the file
+  amrex::Box rows(blk);
+  rows.setBig(0, blk.smallEnd(0));
+  amrex::Vector<double> buf(static_cast<amrex::Long>(n[0]) * m_ncol);
+  amrex::LoopOnCpu(rows, [&](int i, int j, int k) noexcept {
+    amrex::IntVect iv(AMREX_D_DECL(i, j, k));
+    amrex::IntVect src(iv);
+    for (int dir = 1; dir < AMREX_SPACEDIM; ++dir) {
+      src[dir] = wrap(iv[dir], n[dir]);
+    }
+
+    int ii = blk.smallEnd(0);
+    while (ii <= blk.bigEnd(0)) {
+      src[0] = wrap(ii, n[0]);
+      const int len = amrex::min(n[0] - src[0], blk.bigEnd(0) - ii + 1);
+      readRecords(m_domain.index(src), len, buf.data());
+      for (int r = 0; r < len; ++r) {
+        iv[0] = ii + r;
+        const amrex::Long dst = blk.index(iv);
+        for (int c = 0; c < ncomp; ++c) {
+          data[dst + c * npts] = buf[r * m_ncol + comp + c];
+        }
+      }
+      ii += len;
+    }
+  });
+}
+
+void
+BlockReader::coalesce(amrex::Vector<amrex::Box>& blocks)
+{
+  bool merged = true;
+  while (merged) {
+    merged = false;
+    for (int a = 0; (a < blocks.size()) && !merged; ++a) {
+      for (int b = a + 1; b < blocks.size(); ++b) {
+        const amrex::Box both = amrex::minBox(blocks[a], blocks[b]);
+        if (both.numPts() <= blocks[a].numPts() + blocks[b].numPts()) {
+          blocks[a] = both;
+          blocks.erase(blocks.begin() + b);
+          merged = true;
+          break;
+        }
+      }
+    }
+  }
+}
+
+} // namespace pele::pelec
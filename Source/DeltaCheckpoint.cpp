@@ -0,0 +1,472 @@
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <sstream>
+
+#include <AMReX_ParallelDescriptor.H>
+#include <AMReX_Utility.H>
+#include <AMReX_VisMF.H>
+
+#include "DeltaCheckpoint.H"
+
+namespace pele::pelec {
+
+std::string DeltaCheckpoint::s_base;
+std::string DeltaCheckpoint::s_previous;
+amrex::Vector<std::unique_ptr<DeltaCheckpoint::Reference>>
+  DeltaCheckpoint::s_refs;
+
+namespace {
+
+const std::string delta_version = "PeleC-delta-1.0";
+const std::string delta_manifest = "Manifest";
+
+constexpr std::uint64_t fnv_offset = 14695981039346656037ULL;
+constexpr std::uint64_t fnv_prime = 1099511628211ULL;
+
+std::uint64_t
+fnv1a(const void* data, const std::size_t nbytes)
+{
+  const auto* p = static_cast<const unsigned char*>(data);
+  std::uint64_t h = fnv_offset;
+  for (std::size_t i = 0; i < nbytes; i++) {
+    h ^= p[i];
+    h *= fnv_prime;
+  }
+  return h;
+}
+
+// Copy of the valid data of mf in host memory
+std::unique_ptr<amrex::MultiFab>
+host_copy(const amrex::MultiFab& mf)
+{
+  auto hmf = std::make_unique<amrex::MultiFab>(
+    mf.boxArray(), mf.DistributionMap(), mf.nComp(), 0,
+    amrex::MFInfo().SetArena(amrex::The_Pinned_Arena()));
+  amrex::MultiFab::Copy(*hmf, mf, 0, 0, mf.nComp(), 0);
+  amrex::Gpu::streamSynchronize();
+  return hmf;
+}
+
+// Last component of a path, without trailing separators
+std::string
+base_name(std::string path)
+{
+  while ((path.size() > 1) && (path.back() == '/')) {
+    path.pop_back();
+  }
+  const auto pos = path.rfind('/');
+  return (pos == std::string::npos) ? path : path.substr(pos + 1);
+}
+
+std::string
+data_file(const std::string& dir, int lev, int type, int rank)
+{
+  return dir + "/Level_" + std::to_string(lev) + "/" +
+         amrex::Concatenate("SD_" + std::to_string(type) + "_D_", rank, 5);
+}
+
+struct ManifestType
+{
+  int type{0};
+  int ncomp{0};
+  std::uint64_t before{0};
+  std::uint64_t after{0};
+  // Index, rank and offset of the changed boxes
+  amrex::Vector<std::array<amrex::Long, 3>> boxes;
+};
+
+struct ManifestLevel
+{
+  int steps{0};
+  amrex::Real dt{0.0};
+  amrex::BoxArray ba;
+  amrex::Vector<ManifestType> types;
+};
+
+struct Manifest
+{
+  std::string base;
+  std::string previous;
+  int step{0};
+  amrex::Real time{0.0};
+  amrex::Vector<ManifestLevel> levels;
+};
+
+void
+expect(std::istream& is, const std::string& tag, const std::string& file)
+{
+  std::string word;
+  is >> word;
+  if (word != tag) {
+    amrex::Abort(
+      "Delta checkpoint " + file + ": expected " + tag + ", got " + word);
+  }
+}
+
+Manifest
+read_manifest(const std::string& dir)
+{
+  amrex::Vector<char> file_chars;
+  amrex::ParallelDescriptor::ReadAndBcastFile(
+    dir + "/" + delta_manifest, file_chars);
+  std::istringstream is(std::string(file_chars.dataPtr()));
+
+  Manifest m;
+  expect(is, delta_version, dir);
+  expect(is, "base", dir);
+  is >> m.base;
+  expect(is, "previous", dir);
+  is >> m.previous;
+  expect(is, "step", dir);
+  is >> m.step;
+  expect(is, "time", dir);
+  is >> m.time;
+  expect(is, "nlevels", dir);
+  int nlevels = 0;
+  is >> nlevels;
+  m.levels.resize(nlevels);
+  for (int lev = 0; lev < nlevels; lev++) {
+    auto& ml = m.levels[lev];
+    int l = 0;
+    expect(is, "level", dir);
+    is >> l >> ml.steps >> ml.dt;
+    ml.ba.readFrom(is);
+    expect(is, "ntypes", dir);
+    int ntypes = 0;
+    is >> ntypes;
+    ml.types.resize(ntypes);
+    for (auto& mt : ml.types) {
+      int nchanged = 0;
+      expect(is, "type", dir);
+      is >> mt.type >> mt.ncomp >> mt.before >> mt.after >> nchanged;
+      mt.boxes.resize(nchanged);
+      for (auto& box : mt.boxes) {
+        is >> box[0] >> box[1] >> box[2];
+      }
+    }
+  }
+  if (is.fail()) {
+    amrex::Abort("Delta checkpoint " + dir + ": unable to parse the manifest");
+  }
+  return m;
+}
+
+} // namespace
+
+std::uint64_t
+hashMultiFab(const amrex::MultiFab& mf)
+{
+  AMREX_ALWAYS_ASSERT(mf.nGrow() == 0);
+  amrex::Vector<amrex::Long> hashes(mf.size(), 0);
+  for (amrex::MFIter mfi(mf); mfi.isValid(); ++mfi) {
+    const auto& fab = mf[mfi];
+    hashes[mfi.index()] =
+      static_cast<amrex::Long>(fnv1a(fab.dataPtr(), fab.nBytes()));
+  }
+  // Only the owner of each box contributes, so the sum is exact
+  amrex::ParallelDescriptor::ReduceLongSum(
+    hashes.data(), static_cast<int>(hashes.size()));
+  return fnv1a(hashes.data(), hashes.size() * sizeof(amrex::Long));
+}
+
+void
+DeltaCheckpoint::setReference(
+  const int lev,
+  const std::string& base,
+  const std::string& previous,
+  const amrex::Vector<int>& types,
+  const amrex::Vector<const amrex::MultiFab*>& mfs)
+{
+  BL_PROFILE("pele::pelec::DeltaCheckpoint::setReference()");
+  if (base != s_base) {
+    s_refs.clear();
+    s_base = base;
+  }
+  s_previous = previous;
+  if (lev >= s_refs.size()) {
+    s_refs.resize(lev + 1);
+  }
+  auto ref = std::make_unique<Reference>();
+  ref->types = types;
+  for (const auto* mf : mfs) {
+    ref->mfs.push_back(host_copy(*mf));
+  }
+  s_refs[lev] = std::move(ref);
+}
+
+bool
+DeltaCheckpoint::hasReferences(const amrex::Vector<DeltaLevel>& levels)
+{
+  if (levels.size() != s_refs.size()) {
+    return false;
+  }
+  for (int lev = 0; lev < levels.size(); lev++) {
+    const auto& ref = s_refs[lev];
+    const auto& dl = levels[lev];
+    if (
+      !ref || (ref->types != dl.types) ||
+      (ref->mfs[0]->boxArray() != dl.mfs[0]->boxArray()) ||
+      (ref->mfs[0]->DistributionMap() != dl.mfs[0]->DistributionMap())) {
+      return false;
+    }
+  }
+  return true;
+}
+
+amrex::Long
+DeltaCheckpoint::write(
+  const std::string& dir,
+  const int step,
+  const amrex::Real time,
+  const amrex::Vector<DeltaLevel>& levels,
+  const amrex::Real tol,
+  const bool verbose)
+{
+  BL_PROFILE("pele::pelec::DeltaCheckpoint::write()");
+  AMREX_ALWAYS_ASSERT(hasReferences(levels));
+
+  const int nlevels = static_cast<int>(levels.size());
+  const int myproc = amrex::ParallelDescriptor::MyProc();
+  const int IOProc = amrex::ParallelDescriptor::IOProcessorNumber();
+  amrex::PreBuildDirectorHierarchy(dir, "Level_", nlevels, true);
+
+  std::ostringstream manifest;
+  manifest << std::setprecision(17) << delta_version << "\nbase " << s_base
+           << "\nprevious " << (s_previous.empty() ? "none" : s_previous)
+           << "\nstep " << step << "\ntime " << time << "\nnlevels "
+           << nlevels << '\n';
+
+  amrex::Long bytes[2] = {0, 0}; // written, full
+  for (int lev = 0; lev < nlevels; lev++) {
+    const auto& dl = levels[lev];
+    auto& ref = *s_refs[lev];
+    manifest << "level " << lev << ' ' << dl.steps << ' ' << dl.dt << '\n';
+    dl.mfs[0]->boxArray().writeOn(manifest);
+    manifest << "\nntypes " << dl.types.size() << '\n';
+
+    for (int t = 0; t < dl.types.size(); t++) {
+      auto& rmf = *ref.mfs[t];
+      const auto cur = host_copy(*dl.mfs[t]);
+      const int ncomp = cur->nComp();
+      const std::uint64_t before = hashMultiFab(rmf);
+
+      // Largest magnitude of each component
+      amrex::Vector<amrex::Real> scale(ncomp, 0.0);
+      for (amrex::MFIter mfi(*cur); mfi.isValid(); ++mfi) {
+        const auto& fab = (*cur)[mfi];
+        const amrex::Long npts = fab.box().numPts();
+        for (int n = 0; n < ncomp; n++) {
+          const amrex::Real* c = fab.dataPtr(n);
+          for (amrex::Long i = 0; i < npts; i++) {
+            scale[n] = amrex::max(scale[n], std::abs(c[i]));
+          }
+        }
+      }
+      amrex::ParallelDescriptor::ReduceRealMax(scale.data(), ncomp);
+
+      // Write the boxes that changed beyond the tolerance, which become the
+      // reference for the next delta
+      amrex::Vector<amrex::Long> loc(2 * static_cast<std::size_t>(cur->size()));
+      amrex::VisMF::IO_Buffer io_buffer(amrex::VisMF::GetIOBufferSize());
+      std::ofstream ofs;
+      amrex::Long offset = 0;
+      for (amrex::MFIter mfi(*cur); mfi.isValid(); ++mfi) {
+        const auto& cfab = (*cur)[mfi];
+        auto& rfab = rmf[mfi];
+        const amrex::Long npts = cfab.box().numPts();
+        bool changed = false;
+        for (int n = 0; (n < ncomp) && !changed; n++) {
+          const amrex::Real* c = cfab.dataPtr(n);
+          const amrex::Real* r = rfab.dataPtr(n);
+          const amrex::Real thresh = tol * scale[n];
+          for (amrex::Long i = 0; i < npts; i++) {
+            if (!(std::abs(c[i] - r[i]) <= thresh)) {
+              changed = true;
+              break;
+            }
+          }
+        }
+        bytes[1] += static_cast<amrex::Long>(cfab.nBytes());
+        if (!changed) {
+          continue;
+        }
+        if (!ofs.is_open()) {
+          ofs.rdbuf()->pubsetbuf(io_buffer.dataPtr(), io_buffer.size());
+          const std::string fname = data_file(dir, lev, dl.types[t], myproc);
+          ofs.open(fname.c_str(), std::ios::out | std::ios::binary);
+          if (!ofs.good()) {
+            amrex::FileOpenFailed(fname);
+          }
+        }
+        ofs.write(
+          reinterpret_cast<const char*>(cfab.dataPtr()),
+          static_cast<std::streamsize>(cfab.nBytes()));
+        std::memcpy(rfab.dataPtr(), cfab.dataPtr(), cfab.nBytes());
+        loc[2 * mfi.index()] = myproc + 1;
+        loc[2 * mfi.index() + 1] = offset;
+        offset += static_cast<amrex::Long>(cfab.nBytes());
+      }
+      bytes[0] += offset;
+      if (ofs.is_open()) {
+        ofs.close();
+        if (!ofs.good()) {
+          amrex::Abort("Delta checkpoint " + dir + ": write failed");
+        }
+      }
+      amrex::ParallelDescriptor::ReduceLongSum(
+        loc.data(), static_cast<int>(loc.size()), IOProc);
+      const std::uint64_t after = hashMultiFab(rmf);
+
+      int nchanged = 0;
+      std::ostringstream boxes;
+      for (int i = 0; i < cur->size(); i++) {
+        if (loc[2 * i] > 0) {
+          boxes << i << ' ' << loc[2 * i] - 1 << ' ' << loc[2 * i + 1] << '\n';
+          nchanged++;
+        }
+      }
+      manifest << "type " << dl.types[t] << ' ' << ncomp << ' ' << before
+               << ' ' << after << ' ' << nchanged << '\n'
+               << boxes.str();
+    }
+  }
+
+  if (amrex::ParallelDescriptor::IOProcessor()) {
+    std::ofstream ofs((dir + "/" + delta_manifest).c_str());
+    if (!ofs.good()) {
+      amrex::FileOpenFailed(dir + "/" + delta_manifest);
+    }
+    ofs << manifest.str();
+  }
+  s_previous = dir;
+
+  const amrex::Long written = bytes[0];
+  if (verbose) {
+    amrex::ParallelDescriptor::ReduceLongSum(bytes, 2, IOProc);
+    amrex::Print() << "Delta checkpoint " << dir << " (base " << s_base
+                   << "): " << bytes[0] << " of " << bytes[1]
+                   << " bytes written" << std::endl;
+  }
+  return written;
+}
+
+void
+DeltaCheckpoint::restore(
+  const std::string& delta,
+  const std::string& restart_file,
+  const int lev,
+  const amrex::Vector<int>& types,
+  const amrex::Vector<amrex::MultiFab*>& mfs,
+  int& steps,
+  amrex::Real& time,
+  amrex::Real& dt)
+{
+  BL_PROFILE("pele::pelec::DeltaCheckpoint::restore()");
+
+  // Chain of deltas back to the full checkpoint. The deltas of a chain are
+  // written next to each other.
+  const auto sep = delta.rfind('/');
+  const std::string dir =
+    (sep == std::string::npos) ? std::string{} : delta.substr(0, sep + 1);
+  amrex::Vector<std::string> chain{delta};
+  amrex::Vector<Manifest> manifests{read_manifest(delta)};
+  while (manifests.back().previous != "none") {
+    chain.push_back(dir + base_name(manifests.back().previous));
+    manifests.push_back(read_manifest(chain.back()));
+  }
+  if (base_name(manifests.back().base) != base_name(restart_file)) {
+    amrex::Abort(
+      "Delta checkpoint " + delta + " was written after " +
+      manifests.back().base + ", not " + restart_file);
+  }
+
+  amrex::Vector<std::unique_ptr<amrex::MultiFab>> cur;
+  for (const auto* mf : mfs) {
+    cur.push_back(host_copy(*mf));
+  }
+
+  for (int k = static_cast<int>(chain.size()) - 1; k >= 0; k--) {
+    const auto& m = manifests[k];
+    if (lev >= m.levels.size()) {
+      amrex::Abort(
+        "Delta checkpoint " + chain[k] + " has no level " +
+        std::to_string(lev));
+    }
+    const auto& ml = m.levels[lev];
+    if (ml.ba != cur[0]->boxArray()) {
+      amrex::Abort(
+        "Delta checkpoint " + chain[k] + ": grids of level " +
+        std::to_string(lev) + " differ from the checkpoint");
+    }
+    for (const auto& mt : ml.types) {
+      int t = 0;
+      while ((t < types.size()) && (types[t] != mt.type)) {
+        t++;
+      }
+      if (t == types.size()) {
+        continue;
+      }
+      auto& hmf = *cur[t];
+      const std::string what = "Delta checkpoint " + chain[k] +
+                               ": state type " + std::to_string(mt.type) +
+                               " of level " + std::to_string(lev);
+      if ((mt.ncomp != hmf.nComp()) || (hashMultiFab(hmf) != mt.before)) {
+        amrex::Abort(what + " does not match the state it was written after");
+      }
+
+      std::map<amrex::Long, std::array<amrex::Long, 2>> where;
+      for (const auto& box : mt.boxes) {
+        where[box[0]] = {box[1], box[2]};
+      }
+      for (amrex::MFIter mfi(hmf); mfi.isValid(); ++mfi) {
+        const auto it = where.find(mfi.index());
+        if (it == where.end()) {
+          continue;
+        }
+        auto& fab = hmf[mfi];
+        const std::string fname = data_file(
+          chain[k], lev, mt.type, static_cast<int>(it->second[0]));
+        std::ifstream ifs(fname.c_str(), std::ios::in | std::ios::binary);
+        ifs.seekg(it->second[1], std::ios::beg);
+        ifs.read(
+          reinterpret_cast<char*>(fab.dataPtr()),
+          static_cast<std::streamsize>(fab.nBytes()));
+        if (!ifs.good()) {
+          amrex::Abort(what + ": unable to read " + fname);
+        }
+      }
+
+      if (hashMultiFab(hmf) != mt.after) {
+        amrex::Abort(what + " does not match its hash once applied");
+      }
+    }
+    steps = ml.steps;
+    time = m.time;
+    dt = ml.dt;
+  }
+
+  amrex::Vector<const amrex::MultiFab*> cmfs;
+  for (int t = 0; t < mfs.size(); t++) {
+    amrex::MultiFab::Copy(*mfs[t], *cur[t], 0, 0, cur[t]->nComp(), 0);
+    cmfs.push_back(mfs[t]);
+  }
+  amrex::Print() << "Level " << lev << " rebuilt from " << restart_file
+                 << " and " << chain.size() << " delta checkpoint(s)"
+                 << std::endl;
+
+  // The next deltas follow this one
+  setReference(lev, restart_file, delta, types, cmfs);
+}
+
+void
+DeltaCheckpoint::clear()
+{
+  s_refs.clear();
+  s_base.clear();
+  s_previous.clear();
+}
+
+} // namespace pele::pelec
@@ -0,0 +1,284 @@
+#include <fstream>
+#include <iomanip>
+
+#include <AMReX_EBFabFactory.H>
+#include <AMReX_MultiFabUtil.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Utility.H>
+
+#include "DiagProfile.H"
+
+void
+DiagProfile::init(const std::string& a_prefix, std::string_view a_diagName)
+{
+  DiagBase::init(a_prefix, a_diagName);
+
+  amrex::ParmParse pp(a_prefix);
+
+  std::string mode = "planar";
+  pp.query("mode", mode);
+  if (mode == "planar") {
+    m_radial = false;
+    pp.get("normal", m_normal);
+    AMREX_ALWAYS_ASSERT(m_normal >= 0 && m_normal < AMREX_SPACEDIM);
+  } else if (mode == "radial") {
+    m_radial = true;
+    pp.query("axis", m_axis);
+    AMREX_ALWAYS_ASSERT(m_axis >= 0 && m_axis < AMREX_SPACEDIM);
+    amrex::Vector<amrex::Real> center;
+    pp.getarr("center", center, 0, AMREX_SPACEDIM);
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+      m_center[idim] = center[idim];
+    }
+    pp.get("nBins", m_nBins);
+    pp.get("rmax", m_rmax);
+    AMREX_ALWAYS_ASSERT(m_nBins > 0 && m_rmax > 0.0);
+  } else {
+    amrex::Abort("DiagProfile: unknown mode " + mode + ", use planar or radial");
+  }
+
+  int nProcessFields = pp.countval("field_names");
+  AMREX_ASSERT(nProcessFields > 0);
+  m_fieldNames.resize(nProcessFields);
+  for (int f = 0; f < nProcessFields; ++f) {
+    pp.get("field_names", m_fieldNames[f], f);
+  }
+}
+
+void
+DiagProfile::addVars(amrex::Vector<std::string>& a_varList)
+{
+  DiagBase::addVars(a_varList);
+  for (const auto& v : m_fieldNames) {
+    a_varList.push_back(v);
+  }
+}
+
+void
+DiagProfile::prepare(
+  int a_nlevels,
+  const amrex::Vector<amrex::Geometry>& a_geoms,
+  const amrex::Vector<amrex::BoxArray>& a_grids,
+  const amrex::Vector<amrex::DistributionMapping>& a_dmap,
+  const amrex::Vector<std::string>& a_varNames)
+{
+  DiagBase::prepare(a_nlevels, a_geoms, a_grids, a_dmap, a_varNames);
+
+  m_geoms.resize(a_nlevels);
+  m_refRatio.resize(a_nlevels - 1);
+  for (int lev = 0; lev < a_nlevels; ++lev) {
+    m_geoms[lev] = a_geoms[lev];
+    if (lev > 0) {
+      m_refRatio[lev - 1] = amrex::IntVect(AMREX_D_DECL(
+        static_cast<int>(
+          a_geoms[lev - 1].CellSize(0) / a_geoms[lev].CellSize(0)),
+        static_cast<int>(
+          a_geoms[lev - 1].CellSize(1) / a_geoms[lev].CellSize(1)),
+        static_cast<int>(
+          a_geoms[lev - 1].CellSize(2) / a_geoms[lev].CellSize(2))));
+    }
+  }
+
+  m_fieldIndices.resize(m_fieldNames.size());
+  for (int f = 0; f < m_fieldNames.size(); ++f) {
+    m_fieldIndices[f] = -1;
+    for (int v = 0; v < a_varNames.size(); ++v) {
+      if (a_varNames[v] == m_fieldNames[f]) {
+        m_fieldIndices[f] = v;
+      }
+    }
+    if (m_fieldIndices[f] < 0) {
+      amrex::Abort("DiagProfile: field " + m_fieldNames[f] + " not available");
+    }
+  }
+
+  // Planar profiles are binned at the finest level resolution
+  if (!m_radial) {
+    m_nBins = m_geoms[a_nlevels - 1].Domain().length(m_normal);
+  }
+}
+
+void
+DiagProfile::processDiag(
+  int a_nstep,
+  const amrex::Real& a_time,
+  const amrex::Vector<const amrex::MultiFab*>& a_state,
+  const amrex::Vector<std::string>& /*a_varNames*/)
+{
+  const int nlevels = static_cast<int>(a_state.size());
+  const int nfields = static_cast<int>(m_fieldNames.size());
+  const int nBins = m_nBins;
+
+  // Per bin: integrated volume followed by the integral of each field
+  const int nsum = nBins * (nfields + 1);
+  amrex::Gpu::DeviceVector<amrex::Real> d_sums(nsum, 0.0);
+  amrex::Real* sums = d_sums.data();
+
+  amrex::Gpu::DeviceVector<int> d_fieldIdx(nfields);
+  amrex::Gpu::copy(
+    amrex::Gpu::hostToDevice, m_fieldIndices.begin(), m_fieldIndices.end(),
+    d_fieldIdx.begin());
+  const int* fieldIdx = d_fieldIdx.data();
+
+  const bool radial = m_radial;
+  const int normal = m_normal;
+  const int axis = m_axis;
+  const amrex::Real rmax = m_rmax;
+  const amrex::RealVect center = m_center;
+  const int nFilters = static_cast<int>(m_filters.size());
+  const auto* fdata = m_filterData.data();
+
+  for (int lev = 0; lev < nlevels; ++lev) {
+    const amrex::MultiFab& mf = *a_state[lev];
+
+    // Mask out the cells covered by the next finer level
+    amrex::iMultiFab mask;
+    if (lev < nlevels - 1) {
+      mask = amrex::makeFineMask(
+        mf.boxArray(), mf.DistributionMap(), a_state[lev + 1]->boxArray(),
+        m_refRatio[lev], 1, 0);
+    } else {
+      mask.define(mf.boxArray(), mf.DistributionMap(), 1, 0);
+      mask.setVal(1);
+    }
+
+    // Number of finest-level planes spanned by a cell of this level
+    int rr = 1;
+    for (int l = lev; l < nlevels - 1; ++l) {
+      rr *= m_refRatio[l][normal];
+    }
+
+    // Cut cells are weighted by their volume fraction when the data carries
+    // the EB factory of the level
+    amrex::MultiFab unitfrac;
+    const amrex::MultiFab* volfrac = nullptr;
+    const auto* ebfact =
+      dynamic_cast<amrex::EBFArrayBoxFactory const*>(&mf.Factory());
+    if (ebfact != nullptr) {
+      volfrac = &(ebfact->getVolFrac());
+    } else {
+      unitfrac.define(mf.boxArray(), mf.DistributionMap(), 1, 0);
+      unitfrac.setVal(1.0);
+      volfrac = &unitfrac;
+    }
+
+    const auto geomdata = m_geoms[lev].data();
+    const int domlo = m_geoms[lev].Domain().smallEnd(normal);
+    amrex::Real dv = 1.0;
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+      dv *= m_geoms[lev].CellSize(idim);
+    }
+
+    auto const& state_arrs = mf.const_arrays();
+    auto const& mask_arrs = mask.const_arrays();
+    auto const& vfrac_arrs = volfrac->const_arrays();
+    amrex::ParallelFor(
+      mf, [=] AMREX_GPU_DEVICE(int box_no, int i, int j, int k) noexcept {
+        const amrex::Real vf = vfrac_arrs[box_no](i, j, k);
+        if ((mask_arrs[box_no](i, j, k) == 0) || (vf <= 0.0)) {
+          return;
+        }
+        auto const& s = state_arrs[box_no];
+        for (int f = 0; f < nFilters; ++f) {
+          const amrex::Real fval = s(i, j, k, fdata[f].m_filterVarIdx);
+          if ((fval < fdata[f].m_low_val) || (fval > fdata[f].m_high_val)) {
+            return;
+          }
+        }
+        const amrex::Real dvf = dv * vf;
+        if (!radial) {
+          const amrex::IntVect iv(AMREX_D_DECL(i, j, k));
+          const amrex::Real wsub = dvf / rr;
+          for (int r = 0; r < rr; ++r) {
+            const int b = (iv[normal] - domlo) * rr + r;
+            amrex::Gpu::Atomic::AddNoRet(&sums[b * (nfields + 1)], wsub);
+            for (int f = 0; f < nfields; ++f) {
+              amrex::Gpu::Atomic::AddNoRet(
+                &sums[b * (nfields + 1) + 1 + f],
+                wsub * s(i, j, k, fieldIdx[f]));
+            }
+          }
+        } else {
+          const amrex::IntVect iv(AMREX_D_DECL(i, j, k));
+          amrex::Real r2 = 0.0;
+          for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            if (idim != axis) {
+              const amrex::Real x = geomdata.ProbLo(idim) +
+                                    (iv[idim] + 0.5) * geomdata.CellSize(idim);
+              r2 += (x - center[idim]) * (x - center[idim]);
+            }
+          }
+          const int b = static_cast<int>(std::sqrt(r2) / rmax * nBins);
+          if (b >= nBins) {
+            return;
+          }
+          amrex::Gpu::Atomic::AddNoRet(&sums[b * (nfields + 1)], dvf);
+          for (int f = 0; f < nfields; ++f) {
+            amrex::Gpu::Atomic::AddNoRet(
+              &sums[b * (nfields + 1) + 1 + f], dvf * s(i, j, k, fieldIdx[f]));
+          }
+        }
+      });
+  }
+  amrex::Gpu::streamSynchronize();
+
+  amrex::Vector<amrex::Real> h_sums(nsum);
+  amrex::Gpu::copy(
+    amrex::Gpu::deviceToHost, d_sums.begin(), d_sums.end(), h_sums.begin());
+  amrex::ParallelDescriptor::ReduceRealSum(
+    h_sums.data(), nsum, amrex::ParallelDescriptor::IOProcessorNumber());
+
+  if (amrex::ParallelDescriptor::IOProcessor()) {
+    amrex::Vector<amrex::Real> binCoord(nBins);
+    amrex::Vector<amrex::Real> profile(nBins * nfields, 0.0);
+    const amrex::Geometry& fgeom = m_geoms[nlevels - 1];
+    for (int b = 0; b < nBins; ++b) {
+      binCoord[b] = radial ? (b + 0.5) * rmax / nBins
+                           : fgeom.ProbLo(normal) +
+                               (fgeom.Domain().smallEnd(normal) + b + 0.5) *
+                                 fgeom.CellSize(normal);
+      const amrex::Real vol = h_sums[b * (nfields + 1)];
+      if (vol > 0.0) {
+        for (int f = 0; f < nfields; ++f) {
+          profile[b * nfields + f] = h_sums[b * (nfields + 1) + 1 + f] / vol;
+        }
+      }
+    }
+    writeProfileToFile(a_nstep, a_time, binCoord, profile);
+  }
+}
+
+void
+DiagProfile::writeProfileToFile(
+  int a_nstep,
+  const amrex::Real& a_time,
+  const amrex::Vector<amrex::Real>& a_binCoord,
+  const amrex::Vector<amrex::Real>& a_profile)
+{
+  const std::string diagfile = m_diagfile + ".dat";
+  const bool newFile = !amrex::FileExists(diagfile);
+  const int nfields = static_cast<int>(m_fieldNames.size());
+
+  std::ofstream pfile;
+  pfile.open(diagfile.c_str(), std::ios::out | std::ios::app);
+  if (newFile) {
+    pfile << "# " << (m_radial ? "r" : "x" + std::to_string(m_normal));
+    for (const auto& f : m_fieldNames) {
+      pfile << " " << f;
+    }
+    pfile << "\n";
+  }
+  pfile << "# step " << a_nstep << " time " << std::setprecision(12) << a_time
+        << "\n";
+  for (int b = 0; b < a_binCoord.size(); ++b) {
+    pfile << std::setw(20) << std::setprecision(10) << std::scientific
+          << a_binCoord[b];
+    for (int f = 0; f < nfields; ++f) {
+      pfile << std::setw(20) << std::setprecision(10) << std::scientific
+            << a_profile[b * nfields + f];
+    }
+    pfile << "\n";
+  }
+  pfile << "\n\n";
+  pfile.close();
+}
@@ -0,0 +1,314 @@
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+
+#include <AMReX_ParmParse.H>
+#include <AMReX_Utility.H>
+
+#include "DiagSampler.H"
+
+void
+DiagSampler::init(const std::string& a_prefix, std::string_view a_diagName)
+{
+  DiagBase::init(a_prefix, a_diagName);
+
+  amrex::ParmParse pp(a_prefix);
+
+  pp.get("sampler", m_sampler);
+  if (m_sampler == "plane") {
+    amrex::Vector<amrex::Real> origin;
+    amrex::Vector<amrex::Real> axis1;
+    amrex::Vector<amrex::Real> axis2;
+    amrex::Vector<int> npts;
+    pp.getarr("origin", origin, 0, AMREX_SPACEDIM);
+    pp.getarr("axis1", axis1, 0, AMREX_SPACEDIM);
+    pp.getarr("axis2", axis2, 0, AMREX_SPACEDIM);
+    pp.getarr("npts", npts, 0, 2);
+    AMREX_ALWAYS_ASSERT(npts[0] > 0 && npts[1] > 0);
+    for (int j = 0; j < npts[1]; ++j) {
+      const amrex::Real fj =
+        npts[1] > 1 ? static_cast<amrex::Real>(j) / (npts[1] - 1) : 0.0;
+      for (int i = 0; i < npts[0]; ++i) {
+        const amrex::Real fi =
+          npts[0] > 1 ? static_cast<amrex::Real>(i) / (npts[0] - 1) : 0.0;
+        amrex::RealVect x;
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+          x[idim] = origin[idim] + fi * axis1[idim] + fj * axis2[idim];
+        }
+        m_points.push_back(x);
+      }
+    }
+  } else if (m_sampler == "line") {
+    amrex::Vector<amrex::Real> start;
+    amrex::Vector<amrex::Real> end;
+    int npts = 0;
+    pp.getarr("start", start, 0, AMREX_SPACEDIM);
+    pp.getarr("end", end, 0, AMREX_SPACEDIM);
+    pp.get("npts", npts);
+    AMREX_ALWAYS_ASSERT(npts > 0);
+    for (int i = 0; i < npts; ++i) {
+      const amrex::Real fi =
+        npts > 1 ? static_cast<amrex::Real>(i) / (npts - 1) : 0.0;
+      amrex::RealVect x;
+      for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        x[idim] = start[idim] + fi * (end[idim] - start[idim]);
+      }
+      m_points.push_back(x);
+    }
+  } else if (m_sampler == "probes") {
+    const int nvals = pp.countval("locations");
+    if (nvals == 0 || nvals % AMREX_SPACEDIM != 0) {
+      amrex::Abort(
+        "DiagSampler: locations must hold " + std::to_string(AMREX_SPACEDIM) +
+        " coordinates per probe");
+    }
+    amrex::Vector<amrex::Real> locations;
+    pp.getarr("locations", locations, 0, nvals);
+    for (int p = 0; p < nvals / AMREX_SPACEDIM; ++p) {
+      amrex::RealVect x;
+      for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        x[idim] = locations[p * AMREX_SPACEDIM + idim];
+      }
+      m_points.push_back(x);
+    }
+  } else {
+    amrex::Abort(
+      "DiagSampler: unknown sampler " + m_sampler +
+      ", use plane, line or probes");
+  }
+
+  int nProcessFields = pp.countval("field_names");
+  AMREX_ASSERT(nProcessFields > 0);
+  m_fieldNames.resize(nProcessFields);
+  for (int f = 0; f < nProcessFields; ++f) {
+    pp.get("field_names", m_fieldNames[f], f);
+  }
+}
+
+void
+DiagSampler::addVars(amrex::Vector<std::string>& a_varList)
+{
+  DiagBase::addVars(a_varList);
+  for (const auto& v : m_fieldNames) {
+    a_varList.push_back(v);
+  }
+}
+
+void
+DiagSampler::prepare(
+  int a_nlevels,
+  const amrex::Vector<amrex::Geometry>& a_geoms,
+  const amrex::Vector<amrex::BoxArray>& a_grids,
+  const amrex::Vector<amrex::DistributionMapping>& a_dmap,
+  const amrex::Vector<std::string>& a_varNames)
+{
+  DiagBase::prepare(a_nlevels, a_geoms, a_grids, a_dmap, a_varNames);
+
+  m_geoms.resize(a_nlevels);
+  for (int lev = 0; lev < a_nlevels; ++lev) {
+    m_geoms[lev] = a_geoms[lev];
+  }
+
+  m_fieldIndices.resize(m_fieldNames.size());
+  for (int f = 0; f < m_fieldNames.size(); ++f) {
+    m_fieldIndices[f] = -1;
+    for (int v = 0; v < a_varNames.size(); ++v) {
+      if (a_varNames[v] == m_fieldNames[f]) {
+        m_fieldIndices[f] = v;
+      }
+    }
+    if (m_fieldIndices[f] < 0) {
+      amrex::Abort("DiagSampler: field " + m_fieldNames[f] + " not available");
+    }
+  }
+
+  // The owner of each point only changes with the grids
+  bool same = static_cast<int>(m_grids.size()) == a_nlevels;
+  for (int lev = 0; same && lev < a_nlevels; ++lev) {
+    same = (m_grids[lev] == a_grids[lev]) && (m_dmap[lev] == a_dmap[lev]);
+  }
+  if (same) {
+    return;
+  }
+  m_grids.assign(a_grids.begin(), a_grids.begin() + a_nlevels);
+  m_dmap.assign(a_dmap.begin(), a_dmap.begin() + a_nlevels);
+  m_localPoints.assign(a_nlevels, amrex::Vector<int>());
+  m_localBoxes.assign(a_nlevels, amrex::Vector<int>());
+
+  const int myProc = amrex::ParallelDescriptor::MyProc();
+  for (int p = 0; p < m_points.size(); ++p) {
+    bool found = false;
+    for (int lev = a_nlevels - 1; lev >= 0 && !found; --lev) {
+      const amrex::Geometry& geom = a_geoms[lev];
+      amrex::IntVect iv;
+      for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        iv[idim] = static_cast<int>(std::floor(
+          (m_points[p][idim] - geom.ProbLo(idim)) / geom.CellSize(idim)));
+      }
+      // Points on the upper domain faces belong to the last cells
+      iv.min(geom.Domain().bigEnd());
+      if (!geom.Domain().contains(iv)) {
+        continue;
+      }
+      const auto isects =
+        a_grids[lev].intersections(amrex::Box(iv, iv), true, 0);
+      if (!isects.empty()) {
+        found = true;
+        if (a_dmap[lev][isects[0].first] == myProc) {
+          m_localPoints[lev].push_back(p);
+          m_localBoxes[lev].push_back(isects[0].first);
+        }
+      }
+    }
+    if (!found) {
+      amrex::Abort(
+        "DiagSampler: point " + std::to_string(p) + " of " + m_diagfile +
+        " is outside the domain");
+    }
+  }
+}
+
+void
+DiagSampler::processDiag(
+  int a_nstep,
+  const amrex::Real& a_time,
+  const amrex::Vector<const amrex::MultiFab*>& a_state,
+  const amrex::Vector<std::string>& /*a_varNames*/)
+{
+  const int nlevels = static_cast<int>(a_state.size());
+  const int nfields = static_cast<int>(m_fieldNames.size());
+
+  amrex::Gpu::DeviceVector<int> d_fieldIdx(nfields);
+  amrex::Gpu::copy(
+    amrex::Gpu::hostToDevice, m_fieldIndices.begin(), m_fieldIndices.end(),
+    d_fieldIdx.begin());
+  const int* fieldIdx = d_fieldIdx.data();
+
+  // Values of all the points, each point set by the rank that owns it
+  amrex::Vector<amrex::Real> h_vals(m_points.size() * nfields, 0.0);
+
+  for (int lev = 0; lev < nlevels; ++lev) {
+    const int nloc = static_cast<int>(m_localPoints[lev].size());
+    if (nloc == 0) {
+      continue;
+    }
+    const amrex::MultiFab& mf = *a_state[lev];
+    AMREX_ASSERT(mf.nGrow() >= 1);
+
+    amrex::Vector<amrex::Real> h_x(nloc * AMREX_SPACEDIM);
+    amrex::Vector<int> h_box(nloc);
+    for (int q = 0; q < nloc; ++q) {
+      for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        h_x[q * AMREX_SPACEDIM + idim] = m_points[m_localPoints[lev][q]][idim];
+      }
+      h_box[q] = mf.localindex(m_localBoxes[lev][q]);
+    }
+    amrex::Gpu::DeviceVector<amrex::Real> d_x(h_x.size());
+    amrex::Gpu::DeviceVector<int> d_box(nloc);
+    amrex::Gpu::DeviceVector<amrex::Real> d_out(nloc * nfields);
+    amrex::Gpu::copy(
+      amrex::Gpu::hostToDevice, h_x.begin(), h_x.end(), d_x.begin());
+    amrex::Gpu::copy(
+      amrex::Gpu::hostToDevice, h_box.begin(), h_box.end(), d_box.begin());
+    const amrex::Real* xp = d_x.data();
+    const int* boxp = d_box.data();
+    amrex::Real* out = d_out.data();
+
+    const auto geomdata = m_geoms[lev].data();
+    auto const& state_arrs = mf.const_arrays();
+    amrex::ParallelFor(nloc, [=] AMREX_GPU_DEVICE(int q) noexcept {
+      auto const& s = state_arrs[boxp[q]];
+      // Lower cell of the trilinear stencil, the upper one being a ghost
+      // cell at most
+      amrex::GpuArray<int, 3> lo = {0, 0, 0};
+      amrex::GpuArray<amrex::Real, 3> w = {0.0, 0.0, 0.0};
+      for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        const amrex::Real xi =
+          (xp[q * AMREX_SPACEDIM + idim] - geomdata.ProbLo(idim)) *
+            geomdata.InvCellSize(idim) -
+          0.5;
+        lo[idim] = static_cast<int>(amrex::Math::floor(xi));
+        w[idim] = xi - lo[idim];
+      }
+      for (int f = 0; f < nfields; ++f) {
+        amrex::Real v = 0.0;
+        for (int kk = 0; kk < (AMREX_SPACEDIM > 2 ? 2 : 1); ++kk) {
+          for (int jj = 0; jj < (AMREX_SPACEDIM > 1 ? 2 : 1); ++jj) {
+            for (int ii = 0; ii < 2; ++ii) {
+              const amrex::Real wt = (ii != 0 ? w[0] : 1.0 - w[0]) *
+                                     (jj != 0 ? w[1] : 1.0 - w[1]) *
+                                     (kk != 0 ? w[2] : 1.0 - w[2]);
+              v += wt * s(lo[0] + ii, lo[1] + jj, lo[2] + kk, fieldIdx[f]);
+            }
+          }
+        }
+        out[q * nfields + f] = v;
+      }
+    });
+
+    amrex::Vector<amrex::Real> h_out(nloc * nfields);
+    amrex::Gpu::copy(
+      amrex::Gpu::deviceToHost, d_out.begin(), d_out.end(), h_out.begin());
+    for (int q = 0; q < nloc; ++q) {
+      const int p = m_localPoints[lev][q];
+      for (int f = 0; f < nfields; ++f) {
+        h_vals[p * nfields + f] = h_out[q * nfields + f];
+      }
+    }
+  }
+
+  // Each point is owned by a single rank, so the sum gathers the sample
+  amrex::ParallelDescriptor::ReduceRealSum(
+    h_vals.data(), static_cast<int>(h_vals.size()),
+    amrex::ParallelDescriptor::IOProcessorNumber());
+
+  if (amrex::ParallelDescriptor::IOProcessor()) {
+    if (!amrex::FileExists(m_diagfile + ".bin")) {
+      writeHeader();
+    }
+    writeSample(a_nstep, a_time, h_vals);
+  }
+}
+
+void
+DiagSampler::writeHeader() const
+{
+  const std::string hdrfile = m_diagfile + ".hdr";
+  std::ofstream hfile(hdrfile.c_str(), std::ios::out | std::ios::trunc);
+  hfile << "sampler " << m_sampler << "\n";
+  hfile << "real_bytes " << sizeof(amrex::Real) << "\n";
+  hfile << "nfields " << m_fieldNames.size() << "\n";
+  for (const auto& f : m_fieldNames) {
+    hfile << f << "\n";
+  }
+  hfile << "npoints " << m_points.size() << "\n";
+  for (const auto& x : m_points) {
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+      hfile << std::setw(20) << std::setprecision(10) << std::scientific
+            << x[idim];
+    }
+    hfile << "\n";
+  }
+}
+
+void
+DiagSampler::writeSample(
+  int a_nstep,
+  const amrex::Real& a_time,
+  const amrex::Vector<amrex::Real>& a_vals) const
+{
+  const std::string binfile = m_diagfile + ".bin";
+  std::ofstream bfile(
+    binfile.c_str(), std::ios::out | std::ios::app | std::ios::binary);
+  if (!bfile.good()) {
+    amrex::FileOpenFailed(binfile);
+  }
+  const std::int64_t step = a_nstep;
+  const double time = a_time;
+  bfile.write(reinterpret_cast<const char*>(&step), sizeof(step));
+  bfile.write(reinterpret_cast<const char*>(&time), sizeof(time));
+  bfile.write(
+    reinterpret_cast<const char*>(a_vals.data()),
+    static_cast<std::streamsize>(a_vals.size() * sizeof(amrex::Real)));
+}
@@ -21,11 +21,24 @@ pc_compute_diffusion_flux(
   const amrex::FabType typ,
   const int Ncut,
   const EBBndryGeom* ebg,
-  const amrex::Array4<amrex::EBCellFlag const>& flags)
+  const amrex::Array4<amrex::EBCellFlag const>& flags,
+  const pele::pelec::SpeciesList& spec)
 {
   {
     // Compute Extensive diffusion fluxes for X, Y, Z
     BL_PROFILE("PeleC::diffusion_flux()");
+
+    // Mole fractions and species enthalpies on the cells on either side of
+    // the faces, shared by all directions
+    const amrex::Box xhbox = amrex::grow(box, 1);
+    amrex::FArrayBox xh_fab(xhbox, nCompXH, amrex::The_Async_Arena());
+    auto const& xh = xh_fab.array();
+    const auto thermo = pele::pelec::ThermoTable::view();
+    amrex::ParallelFor(
+      xhbox, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
+        pc_species_xh(i, j, k, q, thermo, xh);
+      });
+
     for (int dir = 0; dir < AMREX_SPACEDIM; dir++) {
       const amrex::Real delta = del[dir];
       amrex::Real d1 = 0.0;
@@ -65,12 +78,18 @@ pc_compute_diffusion_flux(
       amrex::ParallelFor(
         ebox, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
           amrex::GpuArray<amrex::Real, dComp_lambda + 1> cf = {0.0};
-          for (int n = 0; n < static_cast<int>(cf.size()); n++) {
+          for (int m = 0; m < spec.n; m++) {
+            pc_move_transcoefs_to_ec(
+              i, j, k, dComp_rhoD + spec.idx[m], coef, cf.data(), dir,
+              do_harmonic);
+          }
+          for (int n = dComp_mu; n <= dComp_lambda; n++) {
             pc_move_transcoefs_to_ec(
               i, j, k, n, coef, cf.data(), dir, do_harmonic);
           }
           pc_diffusion_flux(
-            i, j, k, q, cf, tander, area[dir], flx[dir], delta, dir);
+            i, j, k, q, xh, cf, tander, area[dir], spec, flx[dir], delta,
+            dir);
         });
     }
   }
@@ -1,4 +1,6 @@
 #include "Diffusion.H"
+#include "PerfCounters.H"
+#include "EntropyProd.H"
 
 void
 PeleC::getMOLSrcTerm(
@@ -6,13 +8,17 @@ PeleC::getMOLSrcTerm(
   amrex::MultiFab& MOLSrcTerm,
   amrex::Real /*time*/,
   amrex::Real dt,
-  amrex::Real flux_factor)
+  amrex::Real flux_factor,
+  MOLTiles tiles)
 {
   BL_PROFILE("PeleC::getMOLSrcTerm()");
   if (
     (!diffuse_temp) && (!diffuse_enth) && (!diffuse_spec) && (!diffuse_vel) &&
     (!do_hydro)) {
     MOLSrcTerm.setVal(0, 0, NVAR, MOLSrcTerm.nGrow());
+    if (do_entropy_state) {
+      get_new_data(Entropy_Type).setVal(0.0, ent_visc, ent_chem);
+    }
     return;
   }
 
@@ -64,6 +70,8 @@ PeleC::getMOLSrcTerm(
   const int nCompTr = dComp_lambda + 1;
   const int do_harmonic = 1; // TODO: parmparse this
   const amrex::GpuArray<amrex::Real, AMREX_SPACEDIM> dx = geom.CellSizeArray();
+  const amrex::GpuArray<amrex::Real, AMREX_SPACEDIM> dxinv =
+    geom.InvCellSizeArray();
 
   amrex::Real dx1 = dx[0];
   for (int dir = 1; dir < AMREX_SPACEDIM; ++dir) {
@@ -101,527 +109,609 @@ PeleC::getMOLSrcTerm(
   if (do_reflux && level > 0) {
     fr_as_fine = &getFluxReg(level);
   }
+  // The registers take the fluxes of whole tiles
+  AMREX_ASSERT(
+    (tiles == mol_tiles_all) || (flux_factor == 0) ||
+    ((fr_as_crse == nullptr) && (fr_as_fine == nullptr)));
+
+  // Species with a diffusion flux in each box, all of them unless
+  // pelec.active_species (the nonideal EOS couples all the species)
+  const bool use_active_spec =
+    active_species &&
+    !std::is_same<
+      pele::physics::PhysicsType::eos_type, pele::physics::eos::SRK>::value &&
+    active_spec.isValidFor(MOLSrcTerm);
+  const auto all_spec = pele::pelec::SpeciesList::all();
+
+  // Time spent in the diffusion, hydro and redistribution sections, summed
+  // over threads and used to split the wall time of the loop below
+  const amrex::Real perf_start = pele::pelec::PerfCounters::wtime();
+  amrex::Real perf_diff = 0.0;
+  amrex::Real perf_hyd = 0.0;
+  amrex::Real perf_redist = 0.0;
 
 #ifdef AMREX_USE_OMP
-#pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
+#pragma omp parallel if (amrex::Gpu::notInLaunchRegion())                     \
+  reduction(+ : perf_diff, perf_hyd, perf_redist)
 #endif
   {
     for (amrex::MFIter mfi(MOLSrcTerm, amrex::TilingIfNotGPU()); mfi.isValid();
          ++mfi) {
-      const amrex::Box vbox = mfi.tilebox();
-      int ng = numGrow();
-      const amrex::Box gbox = amrex::grow(vbox, ng);
-      const amrex::Box cbox = amrex::grow(vbox, ng - 1);
-      auto const& MOLSrc = MOLSrcTerm.array(mfi);
-
-      amrex::Real wt = amrex::ParallelDescriptor::second();
-      const auto& flag_fab = flags[mfi];
-      amrex::FabType typ = flag_fab.getType(vbox);
-      if (typ == amrex::FabType::covered) {
-        setV(vbox, NVAR, MOLSrc, 0);
-        if (do_mol_load_balance && (cost != nullptr)) {
-          wt = (amrex::ParallelDescriptor::second() - wt) / vbox.d_numPts();
-          (*cost)[mfi].plus<amrex::RunOn::Device>(wt, vbox);
+      const int ng = numGrow();
+      for (const amrex::Box& vbox :
+           pc_mol_tile_parts(mfi.tilebox(), mfi.validbox(), ng, tiles)) {
+        const amrex::Box gbox = amrex::grow(vbox, ng);
+        const amrex::Box cbox = amrex::grow(vbox, ng - 1);
+        auto const& MOLSrc = MOLSrcTerm.array(mfi);
+
+        amrex::Real wt = amrex::ParallelDescriptor::second();
+        const auto& flag_fab = flags[mfi];
+        amrex::FabType typ = flag_fab.getType(vbox);
+        if (typ == amrex::FabType::covered) {
+          setV(vbox, NVAR, MOLSrc, 0);
+          if (do_mol_load_balance && (cost != nullptr)) {
+            wt = (amrex::ParallelDescriptor::second() - wt) / vbox.d_numPts();
+            (*cost)[mfi].plus<amrex::RunOn::Device>(wt, vbox);
+          }
+          continue;
         }
-        continue;
-      }
-      // Note on typ: if interior cells (vbox) are all covered, no need to
-      // do anything. But otherwise, we need to do EB stuff if there are any
-      // cut cells within 1 grow cell (cbox) due to EB redistribute
-      typ = flag_fab.getType(cbox);
-
-      // TODO: Add check that this is nextra-1
-      //       (better: fix bounds on ebflux computation in hyperbolic routine
-      //                to be a constant, and make sure this matches it)
-      const amrex::Box ebfluxbox = amrex::grow(vbox, 2);
-
-      const int local_i = mfi.LocalIndex();
-      const auto Ncut =
-        (!eb_in_domain)
-          ? 0
-          : static_cast<int>(sv_eb_bndry_grad_stencil[local_i].size());
-      SparseData<amrex::Real, EBBndrySten> eb_flux_thdlocal;
-      if (Ncut > 0) {
-        eb_flux_thdlocal.define(sv_eb_bndry_grad_stencil[local_i], NVAR);
-      }
-      auto* d_sv_eb_bndry_geom =
-        (Ncut > 0 ? sv_eb_bndry_geom[local_i].data() : nullptr);
-
-      const int nqaux = NQAUX > 0 ? NQAUX : 1;
-      amrex::FArrayBox q(gbox, QVAR, amrex::The_Async_Arena());
-      amrex::FArrayBox qaux(gbox, nqaux, amrex::The_Async_Arena());
-      amrex::FArrayBox coeff_cc(gbox, nCompTr, amrex::The_Async_Arena());
-      auto const& sar = S.array(mfi);
-      auto const& qar = q.array();
-      auto const& qauxar = qaux.array();
-
-      // Get primitives, Q, including (Y, T, p, rho) from conserved state
-      // required for D term
-      {
-        BL_PROFILE("PeleC::ctoprim()");
-        amrex::ParallelFor(
-          gbox, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
-            pc_ctoprim(i, j, k, sar, qar, qauxar);
-          });
-      }
-      // TODO deal with NSCBC
-      /*
-            for (int dir = 0; dir < AMREX_SPACEDIM ; dir++)  {
-              const amrex::Box& bxtmp = amrex::surroundingNodes(vbox,dir);
-              amrex::Box TestBox(bxtmp);
-              for(int d=0; d<AMREX_SPACEDIM; ++d) {
-                if (dir!=d) TestBox.grow(d,1);
-              }
+        // Note on typ: if interior cells (vbox) are all covered, no need to
+        // do anything. But otherwise, we need to do EB stuff if there are any
+        // cut cells within 1 grow cell (cbox) due to EB redistribute
+        typ = flag_fab.getType(cbox);
+
+        // TODO: Add check that this is nextra-1
+        //       (better: fix bounds on ebflux computation in hyperbolic routine
+        //                to be a constant, and make sure this matches it)
+        const amrex::Box ebfluxbox = amrex::grow(vbox, 2);
+
+        const int local_i = mfi.LocalIndex();
+        const auto Ncut =
+          (!eb_in_domain)
+            ? 0
+            : static_cast<int>(sv_eb_bndry_grad_stencil[local_i].size());
+        SparseData<amrex::Real, EBBndrySten> eb_flux_thdlocal;
+        if (Ncut > 0) {
+          eb_flux_thdlocal.define(sv_eb_bndry_grad_stencil[local_i], NVAR);
+        }
+        auto* d_sv_eb_bndry_geom =
+          (Ncut > 0 ? sv_eb_bndry_geom[local_i].data() : nullptr);
 
-              bcMask[dir].resize(TestBox,1, amrex::The_Async_Arena());
-              bcMask[dir].setVal(0);
-            }
+        amrex::Real perf_t0 = pele::pelec::PerfCounters::wtime();
 
-            // Becase bcMask is read in the Riemann solver in any case,
-            // here we put physbc values in the appropriate faces for the
-         non-nscbc case set_bc_mask(lo, hi, domain_lo, domain_hi,
-                        AMREX_D_DECL(AMREX_TO_FORTRAN(bcMask[0]),
-                               AMREX_TO_FORTRAN(bcMask[1]),
-                               AMREX_TO_FORTRAN(bcMask[2])));
+        const auto& spec = use_active_spec ? active_spec[mfi] : all_spec;
 
-            if (nscbc_diff == 1)
-            {
-              impose_NSCBC(lo, hi, domain_lo, domain_hi,
-                           AMREX_TO_FORTRAN(Sfab),
-                           AMREX_TO_FORTRAN(q.fab()),
-                           AMREX_TO_FORTRAN(qaux.fab()),
-                           AMREX_D_DECL(AMREX_TO_FORTRAN(bcMask[0]),
-                                  AMREX_TO_FORTRAN(bcMask[1]),
-                                  AMREX_TO_FORTRAN(bcMask[2])),
-                           &flag_nscbc_isAnyPerio, flag_nscbc_perio,
-                           &time, dx, &dt);
-            }
-      */
-      // Compute transport coefficients, coincident with Q
-      auto const& coe_cc = coeff_cc.array();
-      {
-        auto const& qar_yin = q.array(QFS);
-        auto const& qar_Tin = q.array(QTEMP);
-        auto const& qar_rhoin = q.array(QRHO);
-        auto const& coe_rhoD = coeff_cc.array(dComp_rhoD);
-        auto const& coe_mu = coeff_cc.array(dComp_mu);
-        auto const& coe_xi = coeff_cc.array(dComp_xi);
-        auto const& coe_lambda = coeff_cc.array(dComp_lambda);
-        BL_PROFILE("PeleC::get_transport_coeffs()");
-        // Get Transport coefs on GPU.
-        auto const* ltransparm = trans_parms.device_trans_parm();
-        amrex::launch(gbox, [=] AMREX_GPU_DEVICE(amrex::Box const& tbx) {
-          auto trans = pele::physics::PhysicsType::transport();
-          trans.get_transport_coeffs(
-            tbx, qar_yin, qar_Tin, qar_rhoin, coe_rhoD,
-            amrex::Array4<amrex::Real>(), coe_mu, coe_xi, coe_lambda,
-            ltransparm);
-        });
-      }
+        const int nqaux = NQAUX > 0 ? NQAUX : 1;
+        amrex::FArrayBox q(gbox, QVAR, amrex::The_Async_Arena());
+        amrex::FArrayBox qaux(gbox, nqaux, amrex::The_Async_Arena());
+        amrex::FArrayBox coeff_cc(gbox, nCompTr, amrex::The_Async_Arena());
+        auto const& sar = S.array(mfi);
+        auto const& qar = q.array();
+        auto const& qauxar = qaux.array();
 
-      amrex::FArrayBox flux_ec[AMREX_SPACEDIM];
-      const amrex::Box eboxes[AMREX_SPACEDIM] = {AMREX_D_DECL(
-        amrex::surroundingNodes(cbox, 0), amrex::surroundingNodes(cbox, 1),
-        amrex::surroundingNodes(cbox, 2))};
-      amrex::GpuArray<amrex::Array4<amrex::Real>, AMREX_SPACEDIM> flx;
-      const amrex::GpuArray<
-        const amrex::Array4<const amrex::Real>, AMREX_SPACEDIM>
-        area_arr{{AMREX_D_DECL(
-          area[0].array(mfi), area[1].array(mfi), area[2].array(mfi))}};
-      for (int dir = 0; dir < AMREX_SPACEDIM; dir++) {
-        flux_ec[dir].resize(eboxes[dir], NVAR, amrex::The_Async_Arena());
-        flx[dir] = flux_ec[dir].array();
-        setV(eboxes[dir], NVAR, flx[dir], 0);
-      }
+        // Get primitives, Q, including (Y, T, p, rho) from conserved state
+        // required for D term
+        {
+          BL_PROFILE("PeleC::ctoprim()");
+          amrex::ParallelFor(
+            gbox, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
+              pc_ctoprim(i, j, k, sar, qar, qauxar);
+            });
+        }
+        // TODO deal with NSCBC
+        /*
+              for (int dir = 0; dir < AMREX_SPACEDIM ; dir++)  {
+                const amrex::Box& bxtmp = amrex::surroundingNodes(vbox,dir);
+                amrex::Box TestBox(bxtmp);
+                for(int d=0; d<AMREX_SPACEDIM; ++d) {
+                  if (dir!=d) TestBox.grow(d,1);
+                }
+
+                bcMask[dir].resize(TestBox,1, amrex::The_Async_Arena());
+                bcMask[dir].setVal(0);
+              }
 
-      amrex::FArrayBox Dfab(cbox, NVAR, amrex::The_Async_Arena());
-      auto const& Dterm = Dfab.array();
-      setV(cbox, NVAR, Dterm, 0.0);
-
-      pc_compute_diffusion_flux(
-        cbox, qar, coe_cc, flx, area_arr, dx, do_harmonic, typ, Ncut,
-        d_sv_eb_bndry_geom, flags.array(mfi));
-
-      // Compute flux divergence (1/Vol).Div(F.A)
-      {
-        BL_PROFILE("PeleC::pc_flux_div()");
-        auto const& vol = volume.array(mfi);
-        amrex::ParallelFor(
-          cbox, NVAR,
-          [=] AMREX_GPU_DEVICE(int i, int j, int k, int n) noexcept {
-            pc_flux_div(
-              i, j, k, n, AMREX_D_DECL(flx[0], flx[1], flx[2]), vol, Dterm);
+              // Becase bcMask is read in the Riemann solver in any case,
+              // here we put physbc values in the appropriate faces for the
+           non-nscbc case set_bc_mask(lo, hi, domain_lo, domain_hi,
+                          AMREX_D_DECL(AMREX_TO_FORTRAN(bcMask[0]),
+                                 AMREX_TO_FORTRAN(bcMask[1]),
+                                 AMREX_TO_FORTRAN(bcMask[2])));
+
+              if (nscbc_diff == 1)
+              {
+                impose_NSCBC(lo, hi, domain_lo, domain_hi,
+                             AMREX_TO_FORTRAN(Sfab),
+                             AMREX_TO_FORTRAN(q.fab()),
+                             AMREX_TO_FORTRAN(qaux.fab()),
+                             AMREX_D_DECL(AMREX_TO_FORTRAN(bcMask[0]),
+                                    AMREX_TO_FORTRAN(bcMask[1]),
+                                    AMREX_TO_FORTRAN(bcMask[2])),
+                             &flag_nscbc_isAnyPerio, flag_nscbc_perio,
+                             &time, dx, &dt);
+              }
+        */
+        // Compute transport coefficients, coincident with Q
+        auto const& coe_cc = coeff_cc.array();
+        {
+          auto const& qar_yin = q.array(QFS);
+          auto const& qar_Tin = q.array(QTEMP);
+          auto const& qar_rhoin = q.array(QRHO);
+          auto const& coe_rhoD = coeff_cc.array(dComp_rhoD);
+          auto const& coe_mu = coeff_cc.array(dComp_mu);
+          auto const& coe_xi = coeff_cc.array(dComp_xi);
+          auto const& coe_lambda = coeff_cc.array(dComp_lambda);
+          BL_PROFILE("PeleC::get_transport_coeffs()");
+          // Get Transport coefs on GPU.
+          auto const* ltransparm = trans_parms.device_trans_parm();
+          amrex::launch(gbox, [=] AMREX_GPU_DEVICE(amrex::Box const& tbx) {
+            auto trans = pele::physics::PhysicsType::transport();
+            trans.get_transport_coeffs(
+              tbx, qar_yin, qar_Tin, qar_rhoin, coe_rhoD,
+              amrex::Array4<amrex::Real>(), coe_mu, coe_xi, coe_lambda,
+              ltransparm);
           });
-      }
-
-      // Shut off unwanted diffusion after the fact.
-      //      Under normal conditions, you either have diffusion on all or
-      //      none, so this shouldn't be done this way.  However, the regression
-      //      test for diffusion works by diffusing only temperature through
-      //      this process.  Ideally, we'd redo that test to diffuse a passive
-      //      scalar instead....
-
-      if ((!diffuse_temp) && (!diffuse_enth)) {
-        setC(cbox, Eden, Eint, Dterm, 0.0);
-        for (int dir = 0; dir < AMREX_SPACEDIM; dir++) {
-          setC(eboxes[dir], Eden, Eint, flx[dir], 0.0);
         }
-      }
-      if (!diffuse_spec) {
-        setC(cbox, FirstSpec, FirstSpec + NUM_SPECIES, Dterm, 0.0);
-        for (int dir = 0; dir < AMREX_SPACEDIM; dir++) {
-          setC(eboxes[dir], FirstSpec, FirstSpec + NUM_SPECIES, flx[dir], 0.0);
-        }
-      }
 
-      if (!diffuse_vel) {
-        setC(cbox, Xmom, Xmom + 3, Dterm, 0.0);
+        amrex::FArrayBox flux_ec[AMREX_SPACEDIM];
+        const amrex::Box eboxes[AMREX_SPACEDIM] = {AMREX_D_DECL(
+          amrex::surroundingNodes(cbox, 0), amrex::surroundingNodes(cbox, 1),
+          amrex::surroundingNodes(cbox, 2))};
+        amrex::GpuArray<amrex::Array4<amrex::Real>, AMREX_SPACEDIM> flx;
+        const amrex::GpuArray<
+          const amrex::Array4<const amrex::Real>, AMREX_SPACEDIM>
+          area_arr{{AMREX_D_DECL(
+            area[0].array(mfi), area[1].array(mfi), area[2].array(mfi))}};
         for (int dir = 0; dir < AMREX_SPACEDIM; dir++) {
-          setC(eboxes[dir], Xmom, Xmom + 3, flx[dir], 0.0);
+          flux_ec[dir].resize(eboxes[dir], NVAR, amrex::The_Async_Arena());
+          flx[dir] = flux_ec[dir].array();
+          setV(eboxes[dir], NVAR, flx[dir], 0);
         }
-      }
 
-      // Set extensive flux at embedded boundary, potentially
-      // non-zero only for heat flux on isothermal boundaries,
-      // and momentum fluxes at no-slip walls
-      const auto nFlux = sv_eb_flux.empty() ? 0 : sv_eb_flux[local_i].numPts();
-      if (typ == amrex::FabType::singlevalued && Ncut > 0) {
-        eb_flux_thdlocal.setVal(0); // Default to Neumann for all fields
+        amrex::FArrayBox Dfab(cbox, NVAR, amrex::The_Async_Arena());
+        auto const& Dterm = Dfab.array();
+        setV(cbox, NVAR, Dterm, 0.0);
 
-        const auto Nvals = sv_eb_bcval[local_i].numPts();
+        pc_compute_diffusion_flux(
+          cbox, qar, coe_cc, flx, area_arr, dx, do_harmonic, typ, Ncut,
+          d_sv_eb_bndry_geom, flags.array(mfi), spec);
 
-        AMREX_ASSERT(Nvals == Ncut);
-        AMREX_ASSERT(nFlux == Ncut);
-
-        if (eb_isothermal && (diffuse_temp || diffuse_enth)) {
-          {
-            BL_PROFILE("PeleC::pc_apply_eb_boundry_flux_stencil()");
-            pc_apply_eb_boundry_flux_stencil(
-              ebfluxbox, sv_eb_bndry_grad_stencil[local_i].data(), Ncut, qar,
-              QTEMP, coe_cc, dComp_lambda, sv_eb_bcval[local_i].dataPtr(QTEMP),
-              Nvals, eb_flux_thdlocal.dataPtr(Eden), nFlux, 1);
-          }
-        }
-        // Compute momentum transfer at no-slip EB wall
-        if (eb_noslip && diffuse_vel) {
-          {
-            BL_PROFILE("PeleC::pc_apply_eb_boundry_visc_flux_stencil()");
-            pc_apply_eb_boundry_visc_flux_stencil(
-              ebfluxbox, sv_eb_bndry_grad_stencil[local_i].data(), Ncut,
-              d_sv_eb_bndry_geom, Ncut, qar, coe_cc,
-              sv_eb_bcval[local_i].dataPtr(QU), Nvals,
-              eb_flux_thdlocal.dataPtr(Xmom), nFlux);
-          }
-        }
-      }
-
-      // At this point flux_ec contains the diffusive fluxes in each direction
-      // at face centers for the (potentially partially covered) grid-aligned
-      // faces and eb_flux_thdlocal contains the flux for the cut faces. Before
-      // computing hybrid divergence, comptue and add in the hydro fluxes.
-      // Also, Dterm currently contains the divergence of the face-centered
-      // diffusion fluxes.  Increment this with the divergence of the
-      // face-centered hyperbloic fluxes.
-      if (do_hydro && do_mol) {
-        // amrex::FArrayBox flatn(cbox, 1, amrex::The_Async_Arena());
-        // flatn.setVal(1.0); // Set flattening to 1.0
-
-        // save off the diffusion source term and fluxes (don't want to filter
-        // these)
-        amrex::FArrayBox diffusion_flux[AMREX_SPACEDIM];
-        amrex::GpuArray<amrex::Array4<amrex::Real>, AMREX_SPACEDIM>
-          diffusion_flux_arr;
-        if (use_explicit_filter) {
-          for (int dir = 0; dir < AMREX_SPACEDIM; dir++) {
-            diffusion_flux[dir].resize(
-              flux_ec[dir].box(), NVAR, amrex::The_Async_Arena());
-            diffusion_flux_arr[dir] = diffusion_flux[dir].array();
-            copy_array4(
-              flux_ec[dir].box(), flux_ec[dir].nComp(), flx[dir],
-              diffusion_flux_arr[dir]);
-          }
+        // Compute flux divergence (1/Vol).Div(F.A)
+        {
+          BL_PROFILE("PeleC::pc_flux_div()");
+          auto const& vol = volume.array(mfi);
+          amrex::ParallelFor(
+            cbox, NVAR,
+            [=] AMREX_GPU_DEVICE(int i, int j, int k, int n) noexcept {
+              pc_flux_div(
+                i, j, k, n, AMREX_D_DECL(flx[0], flx[1], flx[2]), vol, Dterm);
+            });
         }
 
-        { // Get face-centered hyperbolic fluxes and their divergences.
-          // Get hyp flux at EB wall
-          BL_PROFILE("PeleC::pc_hyp_mol_flux()");
-          amrex::Real* d_eb_flux_thdlocal =
-            (nFlux > 0 ? eb_flux_thdlocal.dataPtr() : nullptr);
-          pc_compute_hyp_mol_flux(
-            cbox, qar, qauxar, flx, area_arr, dx, plm_iorder, use_laxf_flux,
-            flags.array(mfi), d_sv_eb_bndry_geom, Ncut, d_eb_flux_thdlocal,
-            nFlux);
-        }
+        // Shut off unwanted diffusion after the fact.
+        //      Under normal conditions, you either have diffusion on all or
+        //      none, so this shouldn't be done this way.  However, the
+        //      regression test for diffusion works by diffusing only
+        //      temperature through this process.  Ideally, we'd redo that test
+        //      to diffuse a passive scalar instead....
 
-        // Filter hydro source term and fluxes here
-        if (use_explicit_filter) {
-          // Get the hydro term
-          amrex::FArrayBox hydro_flux[AMREX_SPACEDIM];
-          amrex::GpuArray<amrex::Array4<amrex::Real>, AMREX_SPACEDIM>
-            hydro_flux_arr;
+        if ((!diffuse_temp) && (!diffuse_enth)) {
+          setC(cbox, Eden, Eint, Dterm, 0.0);
           for (int dir = 0; dir < AMREX_SPACEDIM; dir++) {
-            hydro_flux[dir].resize(
-              flux_ec[dir].box(), NVAR, amrex::The_Async_Arena());
-            hydro_flux_arr[dir] = hydro_flux[dir].array();
-            lincomb_array4(
-              flux_ec[dir].box(), Density, NVAR, flx[dir],
-              diffusion_flux_arr[dir], 1.0, -1.0, hydro_flux_arr[dir]);
+            setC(eboxes[dir], Eden, Eint, flx[dir], 0.0);
           }
-
-          // Filter
-          const amrex::Box fbox = amrex::grow(cbox, -nGrowF);
+        }
+        if (!diffuse_spec) {
+          setC(cbox, FirstSpec, FirstSpec + NUM_SPECIES, Dterm, 0.0);
           for (int dir = 0; dir < AMREX_SPACEDIM; dir++) {
-            const amrex::Box& bxtmp = amrex::surroundingNodes(fbox, dir);
-            amrex::FArrayBox filtered_hydro_flux(
-              bxtmp, NVAR, amrex::The_Async_Arena());
-            les_filter.apply_filter(
-              bxtmp, hydro_flux[dir], filtered_hydro_flux, Density, NVAR);
-
-            setV(bxtmp, hydro_flux[dir].nComp(), hydro_flux_arr[dir], 0.0);
-            copy_array4(
-              bxtmp, hydro_flux[dir].nComp(), filtered_hydro_flux.array(),
-              hydro_flux_arr[dir]);
+            setC(
+              eboxes[dir], FirstSpec, FirstSpec + NUM_SPECIES, flx[dir], 0.0);
           }
+        }
 
-          // Combine with diffusion
+        if (!diffuse_vel) {
+          setC(cbox, Xmom, Xmom + 3, Dterm, 0.0);
           for (int dir = 0; dir < AMREX_SPACEDIM; dir++) {
-            lincomb_array4(
-              diffusion_flux[dir].box(), Density, NVAR, diffusion_flux_arr[dir],
-              hydro_flux_arr[dir], 1.0, 1.0, flx[dir]);
+            setC(eboxes[dir], Xmom, Xmom + 3, flx[dir], 0.0);
           }
         }
 
-        // Compute flux divergence (1/Vol).Div(F.A)
-        {
-          BL_PROFILE("PeleC::pc_flux_div()");
-          auto const& vol = volume.array(mfi);
+        // Entropy production of the fluxes actually used, before the hydro
+        // fluxes are added to them
+        if (do_entropy_state) {
+          BL_PROFILE("PeleC::pc_entropy_production_fluxes()");
+          auto const& ent = get_new_data(Entropy_Type).array(mfi);
+  #if NUM_SPECIES > 1
+          const bool heat_on = diffuse_temp || diffuse_enth;
           amrex::ParallelFor(
-            cbox, NVAR,
-            [=] AMREX_GPU_DEVICE(int i, int j, int k, int n) noexcept {
-              pc_flux_div(
-                i, j, k, n, AMREX_D_DECL(flx[0], flx[1], flx[2]), vol, Dterm);
+            vbox, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
+              pc_entropy_production_fluxes(
+                i, j, k, qar, coe_cc, flx, area_arr, dxinv, do_harmonic,
+                heat_on, spec, ent);
             });
+  #else
+          setC(vbox, ent_visc, ent_chem, ent, 0.0);
+  #endif
         }
-      }
 
-      if (eb_in_domain) {
-        amrex::Gpu::DeviceVector<int> v_eb_tile_mask(Ncut, 0);
-        int* eb_tile_mask = v_eb_tile_mask.dataPtr();
-        amrex::ParallelFor(Ncut, [=] AMREX_GPU_DEVICE(int icut) {
-          if (ebfluxbox.contains(d_sv_eb_bndry_geom[icut].iv)) {
-            eb_tile_mask[icut] = 1;
-          }
-        });
+        amrex::Real perf_t1 = pele::pelec::PerfCounters::wtime();
+        perf_diff += perf_t1 - perf_t0;
+
+        // Set extensive flux at embedded boundary, potentially
+        // non-zero only for heat flux on isothermal boundaries,
+        // and momentum fluxes at no-slip walls
+        const auto nFlux =
+          sv_eb_flux.empty() ? 0 : sv_eb_flux[local_i].numPts();
         if (typ == amrex::FabType::singlevalued && Ncut > 0) {
-          sv_eb_flux[local_i].merge(eb_flux_thdlocal, 0, NVAR, v_eb_tile_mask);
+          eb_flux_thdlocal.setVal(0); // Default to Neumann for all fields
+
+          const auto Nvals = sv_eb_bcval[local_i].numPts();
+
+          AMREX_ASSERT(Nvals == Ncut);
+          AMREX_ASSERT(nFlux == Ncut);
+
+          if (eb_isothermal && (diffuse_temp || diffuse_enth)) {
+            {
+              BL_PROFILE("PeleC::pc_apply_eb_boundry_flux_stencil()");
+              pc_apply_eb_boundry_flux_stencil(
+                ebfluxbox, sv_eb_bndry_grad_stencil[local_i].data(), Ncut, qar,
+                QTEMP, coe_cc, dComp_lambda,
+                sv_eb_bcval[local_i].dataPtr(QTEMP), Nvals,
+                eb_flux_thdlocal.dataPtr(Eden), nFlux, 1);
+            }
+          }
+          // Compute momentum transfer at no-slip EB wall
+          if (eb_noslip && diffuse_vel) {
+            {
+              BL_PROFILE("PeleC::pc_apply_eb_boundry_visc_flux_stencil()");
+              pc_apply_eb_boundry_visc_flux_stencil(
+                ebfluxbox, sv_eb_bndry_grad_stencil[local_i].data(), Ncut,
+                d_sv_eb_bndry_geom, Ncut, qar, coe_cc,
+                sv_eb_bcval[local_i].dataPtr(QU), Nvals,
+                eb_flux_thdlocal.dataPtr(Xmom), nFlux);
+            }
+          }
         }
 
-        amrex::FArrayBox dm_as_fine;
-        amrex::FArrayBox fab_drho_as_crse;
-        amrex::IArrayBox fab_rrflag_as_crse;
-        if (typ == amrex::FabType::singlevalued) {
-          // Interpolate fluxes from face centers to face centroids
-          // Note that hybrid divergence and redistribution algorithms require
-          // that we be able to compute the conservative divergence on 2 grow
-          // cells, so we need interpolated fluxes on 2 grow cells, and
-          // therefore we need face centered fluxes on 3.
-          {
-            BL_PROFILE("PeleC::pc_apply_face_stencil()");
-            for (int dir = 0; dir < AMREX_SPACEDIM; ++dir) {
-              const auto Nsten =
-                static_cast<int>(flux_interp_stencil[dir][local_i].size());
-              const amrex::Box valid_interped_flux_box =
-                amrex::Box(ebfluxbox).surroundingNodes(dir);
-              if (Nsten > 0) {
-                pc_apply_face_stencil(
-                  valid_interped_flux_box, stencil_volume_box,
-                  flux_interp_stencil[dir][local_i].data(), Nsten, dir, NVAR,
-                  flx[dir]);
-              }
+        // At this point flux_ec contains the diffusive fluxes in each
+        // direction at face centers for the (potentially partially covered)
+        // grid-aligned faces and eb_flux_thdlocal contains the flux for the cut
+        // faces. Before computing hybrid divergence, comptue and add in the
+        // hydro fluxes.
+        // Also, Dterm currently contains the divergence of the face-centered
+        // diffusion fluxes.  Increment this with the divergence of the
+        // face-centered hyperbloic fluxes.
+        if (do_hydro && do_mol) {
+          // amrex::FArrayBox flatn(cbox, 1, amrex::The_Async_Arena());
+          // flatn.setVal(1.0); // Set flattening to 1.0
+
+          // save off the diffusion source term and fluxes (don't want to filter
+          // these)
+          amrex::FArrayBox diffusion_flux[AMREX_SPACEDIM];
+          amrex::GpuArray<amrex::Array4<amrex::Real>, AMREX_SPACEDIM>
+            diffusion_flux_arr;
+          if (use_explicit_filter) {
+            for (int dir = 0; dir < AMREX_SPACEDIM; dir++) {
+              diffusion_flux[dir].resize(
+                flux_ec[dir].box(), NVAR, amrex::The_Async_Arena());
+              diffusion_flux_arr[dir] = diffusion_flux[dir].array();
+              copy_array4(
+                flux_ec[dir].box(), flux_ec[dir].nComp(), flx[dir],
+                diffusion_flux_arr[dir]);
             }
-            amrex::Gpu::Device::streamSynchronize();
           }
 
-          // Get "hybrid flux divergence" and redistribute
-          //
-          // This operation takes as input centroid-centered fluxes and a
-          // corresponding
-          //  divergence on three grid cells.  Actually, we assume that
-          //  div=(1/VOL)Div(flux) (VOL = volume of the full cells), and that
-          //  flux is EXTENSIVE, weighted with the full face areas.
-          //
-          // Upon return:
-          // div = kappa.(1/Vol) Div(FluxC.Area)  Vol = kappa.VOL,
-          // Area=aperture.AREA, defined over the valid box
-
-          // TODO: Rework this for r-z, if applicable
-          amrex::Real vol = 1;
-          for (int dir = 0; dir < AMREX_SPACEDIM; ++dir) {
-            vol *= geom.CellSize()[dir];
+          { // Get face-centered hyperbolic fluxes and their divergences.
+            // Get hyp flux at EB wall
+            BL_PROFILE("PeleC::pc_hyp_mol_flux()");
+            amrex::Real* d_eb_flux_thdlocal =
+              (nFlux > 0 ? eb_flux_thdlocal.dataPtr() : nullptr);
+            pc_compute_hyp_mol_flux(
+              cbox, qar, qauxar, flx, area_arr, dx, plm_iorder, use_laxf_flux,
+              flags.array(mfi), d_sv_eb_bndry_geom, Ncut, d_eb_flux_thdlocal,
+              nFlux);
           }
 
-          dm_as_fine.resize(
-            amrex::Box::TheUnitBox(), NVAR, amrex::The_Async_Arena());
-          fab_drho_as_crse.resize(
-            amrex::Box::TheUnitBox(), NVAR, amrex::The_Async_Arena());
-          fab_rrflag_as_crse.resize(
-            amrex::Box::TheUnitBox(), 1, amrex::The_Async_Arena());
-          {
-            if (fr_as_fine != nullptr) {
-              dm_as_fine.resize(
-                amrex::grow(vbox, 1), NVAR, amrex::The_Async_Arena());
-              dm_as_fine.setVal<amrex::RunOn::Device>(0.0);
+          // Filter hydro source term and fluxes here
+          if (use_explicit_filter) {
+            // Get the hydro term
+            amrex::FArrayBox hydro_flux[AMREX_SPACEDIM];
+            amrex::GpuArray<amrex::Array4<amrex::Real>, AMREX_SPACEDIM>
+              hydro_flux_arr;
+            for (int dir = 0; dir < AMREX_SPACEDIM; dir++) {
+              hydro_flux[dir].resize(
+                flux_ec[dir].box(), NVAR, amrex::The_Async_Arena());
+              hydro_flux_arr[dir] = hydro_flux[dir].array();
+              lincomb_array4(
+                flux_ec[dir].box(), Density, NVAR, flx[dir],
+                diffusion_flux_arr[dir], 1.0, -1.0, hydro_flux_arr[dir]);
             }
-            if (Ncut > 0) {
-              BL_PROFILE("PeleC::pc_eb_div()");
-              pc_eb_div(
-                vbox, vol, NVAR, d_sv_eb_bndry_geom, Ncut,
-                AMREX_D_DECL(flx[0], flx[1], flx[2]),
-                sv_eb_flux[local_i].dataPtr(), vfrac.array(mfi), Dterm);
+
+            // Filter
+            const amrex::Box fbox = amrex::grow(cbox, -nGrowF);
+            for (int dir = 0; dir < AMREX_SPACEDIM; dir++) {
+              const amrex::Box& bxtmp = amrex::surroundingNodes(fbox, dir);
+              amrex::FArrayBox filtered_hydro_flux(
+                bxtmp, NVAR, amrex::The_Async_Arena());
+              les_filter.apply_filter(
+                bxtmp, hydro_flux[dir], filtered_hydro_flux, Density, NVAR);
+
+              setV(bxtmp, hydro_flux[dir].nComp(), hydro_flux_arr[dir], 0.0);
+              copy_array4(
+                bxtmp, hydro_flux[dir].nComp(), filtered_hydro_flux.array(),
+                hydro_flux_arr[dir]);
+            }
+
+            // Combine with diffusion
+            for (int dir = 0; dir < AMREX_SPACEDIM; dir++) {
+              lincomb_array4(
+                diffusion_flux[dir].box(), Density, NVAR,
+                diffusion_flux_arr[dir], hydro_flux_arr[dir], 1.0, 1.0,
+                flx[dir]);
             }
           }
 
-          if (do_reflux && flux_factor != 0) {
-            for (auto& dir : flux_ec) {
-              dir.mult<amrex::RunOn::Device>(flux_factor, dir.box());
+          // Compute flux divergence (1/Vol).Div(F.A)
+          {
+            BL_PROFILE("PeleC::pc_flux_div()");
+            auto const& vol = volume.array(mfi);
+            amrex::ParallelFor(
+              cbox, NVAR,
+              [=] AMREX_GPU_DEVICE(int i, int j, int k, int n) noexcept {
+                pc_flux_div(
+                  i, j, k, n, AMREX_D_DECL(flx[0], flx[1], flx[2]), vol, Dterm);
+              });
+          }
+        }
+
+        perf_t0 = pele::pelec::PerfCounters::wtime();
+        perf_hyd += perf_t0 - perf_t1;
+
+        if (eb_in_domain) {
+          amrex::Gpu::DeviceVector<int> v_eb_tile_mask(Ncut, 0);
+          int* eb_tile_mask = v_eb_tile_mask.dataPtr();
+          amrex::ParallelFor(Ncut, [=] AMREX_GPU_DEVICE(int icut) {
+            if (ebfluxbox.contains(d_sv_eb_bndry_geom[icut].iv)) {
+              eb_tile_mask[icut] = 1;
             }
+          });
+          if (typ == amrex::FabType::singlevalued && Ncut > 0) {
+            sv_eb_flux[local_i].merge(
+              eb_flux_thdlocal, 0, NVAR, v_eb_tile_mask);
+          }
 
-            if (fr_as_crse != nullptr) {
-              fr_as_crse->CrseAdd(
-                mfi, {AMREX_D_DECL(&flux_ec[0], &flux_ec[1], &flux_ec[2])},
-                dxD.data(), dt, vfrac[mfi],
-                {AMREX_D_DECL(
-                  &((*areafrac[0])[mfi]), &((*areafrac[1])[mfi]),
-                  &((*areafrac[2])[mfi]))},
-                amrex::RunOn::Device);
+          amrex::FArrayBox dm_as_fine;
+          amrex::FArrayBox fab_drho_as_crse;
+          amrex::IArrayBox fab_rrflag_as_crse;
+          if (typ == amrex::FabType::singlevalued) {
+            // Interpolate fluxes from face centers to face centroids
+            // Note that hybrid divergence and redistribution algorithms require
+            // that we be able to compute the conservative divergence on 2 grow
+            // cells, so we need interpolated fluxes on 2 grow cells, and
+            // therefore we need face centered fluxes on 3.
+            {
+              BL_PROFILE("PeleC::pc_apply_face_stencil()");
+              for (int dir = 0; dir < AMREX_SPACEDIM; ++dir) {
+                const auto Nsten =
+                  static_cast<int>(flux_interp_stencil[dir][local_i].size());
+                const amrex::Box valid_interped_flux_box =
+                  amrex::Box(ebfluxbox).surroundingNodes(dir);
+                if (Nsten > 0) {
+                  pc_apply_face_stencil(
+                    valid_interped_flux_box, stencil_volume_box,
+                    flux_interp_stencil[dir][local_i].data(), Nsten, dir, NVAR,
+                    flx[dir]);
+                }
+              }
+              amrex::Gpu::Device::streamSynchronize();
+            }
+
+            // Get "hybrid flux divergence" and redistribute
+            //
+            // This operation takes as input centroid-centered fluxes and a
+            // corresponding
+            //  divergence on three grid cells.  Actually, we assume that
+            //  div=(1/VOL)Div(flux) (VOL = volume of the full cells), and that
+            //  flux is EXTENSIVE, weighted with the full face areas.
+            //
+            // Upon return:
+            // div = kappa.(1/Vol) Div(FluxC.Area)  Vol = kappa.VOL,
+            // Area=aperture.AREA, defined over the valid box
+
+            // TODO: Rework this for r-z, if applicable
+            amrex::Real vol = 1;
+            for (int dir = 0; dir < AMREX_SPACEDIM; ++dir) {
+              vol *= geom.CellSize()[dir];
+            }
+
+            dm_as_fine.resize(
+              amrex::Box::TheUnitBox(), NVAR, amrex::The_Async_Arena());
+            fab_drho_as_crse.resize(
+              amrex::Box::TheUnitBox(), NVAR, amrex::The_Async_Arena());
+            fab_rrflag_as_crse.resize(
+              amrex::Box::TheUnitBox(), 1, amrex::The_Async_Arena());
+            {
+              if (fr_as_fine != nullptr) {
+                dm_as_fine.resize(
+                  amrex::grow(vbox, 1), NVAR, amrex::The_Async_Arena());
+                dm_as_fine.setVal<amrex::RunOn::Device>(0.0);
+              }
+              if (Ncut > 0) {
+                BL_PROFILE("PeleC::pc_eb_div()");
+                pc_eb_div(
+                  vbox, vol, NVAR, d_sv_eb_bndry_geom, Ncut,
+                  AMREX_D_DECL(flx[0], flx[1], flx[2]),
+                  sv_eb_flux[local_i].dataPtr(), vfrac.array(mfi), Dterm);
+              }
             }
 
-            if (fr_as_fine != nullptr) {
-              fr_as_fine->FineAdd(
-                mfi, {AMREX_D_DECL(&flux_ec[0], &flux_ec[1], &flux_ec[2])},
-                dxD.data(), dt, vfrac[mfi],
-                {AMREX_D_DECL(
-                  &((*areafrac[0])[mfi]), &((*areafrac[1])[mfi]),
-                  &((*areafrac[2])[mfi]))},
-                dm_as_fine, amrex::RunOn::Device);
+            if (do_reflux && flux_factor != 0) {
+              for (auto& dir : flux_ec) {
+                dir.mult<amrex::RunOn::Device>(flux_factor, dir.box());
+              }
+
+              if (fr_as_crse != nullptr) {
+                fr_as_crse->CrseAdd(
+                  mfi, {AMREX_D_DECL(&flux_ec[0], &flux_ec[1], &flux_ec[2])},
+                  dxD.data(), dt, vfrac[mfi],
+                  {AMREX_D_DECL(
+                    &((*areafrac[0])[mfi]), &((*areafrac[1])[mfi]),
+                    &((*areafrac[2])[mfi]))},
+                  amrex::RunOn::Device);
+              }
+
+              if (fr_as_fine != nullptr) {
+                fr_as_fine->FineAdd(
+                  mfi, {AMREX_D_DECL(&flux_ec[0], &flux_ec[1], &flux_ec[2])},
+                  dxD.data(), dt, vfrac[mfi],
+                  {AMREX_D_DECL(
+                    &((*areafrac[0])[mfi]), &((*areafrac[1])[mfi]),
+                    &((*areafrac[2])[mfi]))},
+                  dm_as_fine, amrex::RunOn::Device);
+              }
             }
+          } else if (typ != amrex::FabType::regular) { // Single valued if loop
+            amrex::Abort("multi-valued eb boundary fluxes to be implemented");
           }
-        } else if (typ != amrex::FabType::regular) { // Single valued if loop
-          amrex::Abort("multi-valued eb boundary fluxes to be implemented");
         }
-      }
 
-      if (do_reflux && flux_factor != 0 && typ == amrex::FabType::regular) {
-        for (int dir = 0; dir < AMREX_SPACEDIM; dir++) {
+        if (do_reflux && flux_factor != 0 && typ == amrex::FabType::regular) {
+          for (int dir = 0; dir < AMREX_SPACEDIM; dir++) {
+            amrex::ParallelFor(
+              eboxes[dir], NVAR,
+              [=] AMREX_GPU_DEVICE(int i, int j, int k, int n) noexcept {
+                flx[dir](i, j, k, n) *= flux_factor;
+              });
+          }
+
+          if ((level < parent->finestLevel()) && (fr_as_crse != nullptr)) {
+            fr_as_crse->CrseAdd(
+              mfi, {{AMREX_D_DECL(&flux_ec[0], &flux_ec[1], &flux_ec[2])}},
+              dxD.data(), dt, amrex::RunOn::Device);
+          }
+
+          if ((level > 0) && (fr_as_fine != nullptr)) {
+            fr_as_fine->FineAdd(
+              mfi, {{AMREX_D_DECL(&flux_ec[0], &flux_ec[1], &flux_ec[2])}},
+              dxD.data(), dt, amrex::RunOn::Device);
+          }
+        }
+
+        // Extrapolate to GhostCells
+        if (MOLSrcTerm.nGrow() > 0) {
+          BL_PROFILE("PeleC::diffextrap()");
+          const int mg = MOLSrcTerm.nGrow();
+          const auto* low = vbox.loVect();
+          const auto* high = vbox.hiVect();
+          auto dlo = Dterm.begin;
+          auto dhi = Dterm.end;
+          const int AMREX_D_DECL(lx = low[0], ly = low[1], lz = low[2]);
+          const int AMREX_D_DECL(hx = high[0], hy = high[1], hz = high[2]);
           amrex::ParallelFor(
-            eboxes[dir], NVAR,
-            [=] AMREX_GPU_DEVICE(int i, int j, int k, int n) noexcept {
-              flx[dir](i, j, k, n) *= flux_factor;
+            vbox, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
+              pc_diffextrap(
+                i, j, k, Dterm, mg, UMX, UMZ + 1, AMREX_D_DECL(lx, ly, lz),
+                AMREX_D_DECL(hx, hy, hz), dlo, dhi);
+              pc_diffextrap(
+                i, j, k, Dterm, mg, UFS, UFS + NUM_SPECIES,
+                AMREX_D_DECL(lx, ly, lz), AMREX_D_DECL(hx, hy, hz), dlo, dhi);
+              pc_diffextrap(
+                i, j, k, Dterm, mg, UEDEN, UEDEN + 1, AMREX_D_DECL(lx, ly, lz),
+                AMREX_D_DECL(hx, hy, hz), dlo, dhi);
             });
         }
 
-        if ((level < parent->finestLevel()) && (fr_as_crse != nullptr)) {
-          fr_as_crse->CrseAdd(
-            mfi, {{AMREX_D_DECL(&flux_ec[0], &flux_ec[1], &flux_ec[2])}},
-            dxD.data(), dt, amrex::RunOn::Device);
-        }
+        // EB redistribution
+        perf_t1 = pele::pelec::PerfCounters::wtime();
+        if (eb_in_domain && (typ != amrex::FabType::regular)) {
+          AMREX_D_TERM(auto apx = areafrac[0]->const_array(mfi);
+                       , auto apy = areafrac[1]->const_array(mfi);
+                       , auto apz = areafrac[2]->const_array(mfi););
+          AMREX_D_TERM(auto fcx = facecent[0]->const_array(mfi);
+                       , auto fcy = facecent[1]->const_array(mfi);
+                       , auto fcz = facecent[2]->const_array(mfi););
+          auto ccc = fact.getCentroid().const_array(mfi);
+
+          amrex::FArrayBox tmpfab(
+            Dfab.box(), S.nComp(), amrex::The_Async_Arena());
+          if (redistribution_type == "FluxRedist") {
+            tmpfab.setVal<amrex::RunOn::Device>(1.0, tmpfab.box());
+          }
+          amrex::Array4<amrex::Real> scratch = tmpfab.array();
 
-        if ((level > 0) && (fr_as_fine != nullptr)) {
-          fr_as_fine->FineAdd(
-            mfi, {{AMREX_D_DECL(&flux_ec[0], &flux_ec[1], &flux_ec[2])}},
-            dxD.data(), dt, amrex::RunOn::Device);
-        }
-      }
+          amrex::FArrayBox Dterm_tmpfab(
+            Dfab.box(), S.nComp(), amrex::The_Async_Arena());
+          amrex::Array4<amrex::Real> Dterm_tmp = Dterm_tmpfab.array();
+          copy_array4(Dfab.box(), NVAR, Dterm, Dterm_tmp);
 
-      // Extrapolate to GhostCells
-      if (MOLSrcTerm.nGrow() > 0) {
-        BL_PROFILE("PeleC::diffextrap()");
-        const int mg = MOLSrcTerm.nGrow();
-        const auto* low = vbox.loVect();
-        const auto* high = vbox.hiVect();
-        auto dlo = Dterm.begin;
-        auto dhi = Dterm.end;
-        const int AMREX_D_DECL(lx = low[0], ly = low[1], lz = low[2]);
-        const int AMREX_D_DECL(hx = high[0], hy = high[1], hz = high[2]);
-        amrex::ParallelFor(
-          vbox, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
-            pc_diffextrap(
-              i, j, k, Dterm, mg, UMX, UMZ + 1, AMREX_D_DECL(lx, ly, lz),
-              AMREX_D_DECL(hx, hy, hz), dlo, dhi);
-            pc_diffextrap(
-              i, j, k, Dterm, mg, UFS, UFS + NUM_SPECIES,
-              AMREX_D_DECL(lx, ly, lz), AMREX_D_DECL(hx, hy, hz), dlo, dhi);
-            pc_diffextrap(
-              i, j, k, Dterm, mg, UEDEN, UEDEN + 1, AMREX_D_DECL(lx, ly, lz),
-              AMREX_D_DECL(hx, hy, hz), dlo, dhi);
-          });
-      }
+          auto flag_arr = flags.const_array(mfi);
+          {
+            BL_PROFILE("Redistribution::Apply()");
+            Redistribution::Apply(
+              vbox, S.nComp(), Dterm, Dterm_tmp, S.const_array(mfi), scratch,
+              flag_arr, AMREX_D_DECL(apx, apy, apz), vfrac.const_array(mfi),
+              AMREX_D_DECL(fcx, fcy, fcz), ccc, d_bcs.dataPtr(), geom, dt,
+              redistribution_type, eb_srd_max_order);
+          }
 
-      // EB redistribution
-      if (eb_in_domain && (typ != amrex::FabType::regular)) {
-        AMREX_D_TERM(auto apx = areafrac[0]->const_array(mfi);
-                     , auto apy = areafrac[1]->const_array(mfi);
-                     , auto apz = areafrac[2]->const_array(mfi););
-        AMREX_D_TERM(auto fcx = facecent[0]->const_array(mfi);
-                     , auto fcy = facecent[1]->const_array(mfi);
-                     , auto fcz = facecent[2]->const_array(mfi););
-        auto ccc = fact.getCentroid().const_array(mfi);
-
-        amrex::FArrayBox tmpfab(
-          Dfab.box(), S.nComp(), amrex::The_Async_Arena());
-        if (redistribution_type == "FluxRedist") {
-          tmpfab.setVal<amrex::RunOn::Device>(1.0, tmpfab.box());
-        }
-        amrex::Array4<amrex::Real> scratch = tmpfab.array();
+          // Make sure div is zero in covered cells
+          amrex::ParallelFor(
+            vbox, S.nComp(),
+            [=] AMREX_GPU_DEVICE(int i, int j, int k, int n) noexcept {
+              if (flag_arr(i, j, k).isCovered()) {
+                Dterm(i, j, k, n) = 0.0;
+              }
+            });
 
-        amrex::FArrayBox Dterm_tmpfab(
-          Dfab.box(), S.nComp(), amrex::The_Async_Arena());
-        amrex::Array4<amrex::Real> Dterm_tmp = Dterm_tmpfab.array();
-        copy_array4(Dfab.box(), NVAR, Dterm, Dterm_tmp);
+          // Make sure rho div is same as sum rhoY div
+          amrex::ParallelFor(
+            vbox, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
+              Dterm(i, j, k, URHO) = 0.0;
+              for (int n = 0; n < NUM_SPECIES; n++) {
+                Dterm(i, j, k, URHO) += Dterm(i, j, k, UFS + n);
+              }
+            });
 
-        auto flag_arr = flags.const_array(mfi);
-        {
-          BL_PROFILE("Redistribution::Apply()");
-          Redistribution::Apply(
-            vbox, S.nComp(), Dterm, Dterm_tmp, S.const_array(mfi), scratch,
-            flag_arr, AMREX_D_DECL(apx, apy, apz), vfrac.const_array(mfi),
-            AMREX_D_DECL(fcx, fcy, fcz), ccc, d_bcs.dataPtr(), geom, dt,
-            redistribution_type, eb_srd_max_order);
+          // Make sure the massfractions are ok in cut cells
+          if ((eb_clean_massfrac) && (typ != amrex::FabType::covered)) {
+            pc_eb_clean_massfrac(
+              vbox, dt, eb_clean_massfrac_threshold, S.const_array(mfi),
+              flag_arr, scratch, Dterm);
+          }
         }
 
-        // Make sure div is zero in covered cells
-        amrex::ParallelFor(
-          vbox, S.nComp(),
-          [=] AMREX_GPU_DEVICE(int i, int j, int k, int n) noexcept {
-            if (flag_arr(i, j, k).isCovered()) {
-              Dterm(i, j, k, n) = 0.0;
-            }
-          });
+        perf_redist += pele::pelec::PerfCounters::wtime() - perf_t1;
 
-        // Make sure rho div is same as sum rhoY div
-        amrex::ParallelFor(
-          vbox, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
-            Dterm(i, j, k, URHO) = 0.0;
-            for (int n = 0; n < NUM_SPECIES; n++) {
-              Dterm(i, j, k, URHO) += Dterm(i, j, k, UFS + n);
-            }
-          });
+        copy_array4(vbox, NVAR, Dterm, MOLSrc);
 
-        // Make sure the massfractions are ok in cut cells
-        if ((eb_clean_massfrac) && (typ != amrex::FabType::covered)) {
-          pc_eb_clean_massfrac(
-            vbox, dt, eb_clean_massfrac_threshold, S.const_array(mfi), flag_arr,
-            scratch, Dterm);
+        if (do_mol_load_balance && (cost != nullptr)) {
+          amrex::Gpu::streamSynchronize();
+          wt = (amrex::ParallelDescriptor::second() - wt) / vbox.d_numPts();
+          (*cost)[mfi].plus<amrex::RunOn::Device>(wt, vbox);
         }
       }
+    }
+  }
 
-      copy_array4(vbox, NVAR, Dterm, MOLSrc);
-
-      if (do_mol_load_balance && (cost != nullptr)) {
-        amrex::Gpu::streamSynchronize();
-        wt = (amrex::ParallelDescriptor::second() - wt) / vbox.d_numPts();
-        (*cost)[mfi].plus<amrex::RunOn::Device>(wt, vbox);
-      }
+  const amrex::Real perf_wall = pele::pelec::PerfCounters::wtime() - perf_start;
+  const amrex::Real perf_sum = perf_diff + perf_hyd + perf_redist;
+  if (perf_sum > 0.0) {
+    // Cells are counted once for the two halves of an overlapped evaluation
+    const amrex::Long ncells =
+      (tiles == mol_tiles_interior) ? 0 : grids.numPts();
+    const auto rsize = static_cast<amrex::Long>(sizeof(amrex::Real));
+    pele::pelec::PerfCounters::add(
+      level, pele::pelec::perf_diffusion, perf_wall * perf_diff / perf_sum,
+      ncells, ncells * (2 * NVAR + QVAR + nCompTr) * rsize);
+    if (do_hydro && do_mol) {
+      pele::pelec::PerfCounters::add(
+        level, pele::pelec::perf_hydro, perf_wall * perf_hyd / perf_sum,
+        ncells, ncells * (3 * NVAR + QVAR) * rsize);
+    }
+    if (eb_in_domain) {
+      pele::pelec::PerfCounters::add(
+        level, pele::pelec::perf_eb_redist, perf_wall * perf_redist / perf_sum,
+        ncells, ncells * 4 * NVAR * rsize);
     }
   }
 }
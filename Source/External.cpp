@@ -8,15 +8,15 @@ PeleC::construct_old_ext_source(amrex::Real time, amrex::Real dt)
 
   int ng = 0; // None filled
 
-  old_sources[ext_src]->setVal(0.0);
+  amrex::MultiFab& src = old_sources[ext_src]->fill();
+  src.setVal(0.0);
 
-  if (!add_ext_src) {
-    return;
-  }
-
-  fill_ext_source(time, dt, S_old, S_old, *old_sources[ext_src], ng);
+  if (add_ext_src) {
+    fill_ext_source(time, dt, S_old, S_old, src, ng);
 
-  old_sources[ext_src]->FillBoundary(geom.periodicity());
+    src.FillBoundary(geom.periodicity());
+  }
+  old_sources[ext_src]->commit();
 }
 
 void
@@ -27,13 +27,13 @@ PeleC::construct_new_ext_source(amrex::Real time, amrex::Real dt)
 
   int ng = 0;
 
-  new_sources[ext_src]->setVal(0.0);
+  amrex::MultiFab& src = new_sources[ext_src]->fill();
+  src.setVal(0.0);
 
-  if (!add_ext_src) {
-    return;
+  if (add_ext_src) {
+    fill_ext_source(time, dt, S_old, S_new, src, ng);
   }
-
-  fill_ext_source(time, dt, S_old, S_new, *new_sources[ext_src], ng);
+  new_sources[ext_src]->commit();
 }
 
 void
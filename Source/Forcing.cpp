@@ -12,15 +12,15 @@ PeleC::construct_old_forcing_source(amrex::Real /*time*/, amrex::Real /*dt*/)
 
   int ng = 0;
 
-  old_sources[forcing_src]->setVal(0.0);
+  amrex::MultiFab& src = old_sources[forcing_src]->fill();
+  src.setVal(0.0);
 
-  if (!add_forcing_src) {
-    return;
-  }
-
-  fill_forcing_source(S_old, S_old, *old_sources[forcing_src], ng);
+  if (add_forcing_src) {
+    fill_forcing_source(S_old, S_old, src, ng);
 
-  old_sources[forcing_src]->FillBoundary(geom.periodicity());
+    src.FillBoundary(geom.periodicity());
+  }
+  old_sources[forcing_src]->commit();
 }
 
 void
@@ -31,13 +31,13 @@ PeleC::construct_new_forcing_source(amrex::Real /*time*/, amrex::Real /*dt*/)
 
   int ng = 0;
 
-  new_sources[forcing_src]->setVal(0.0);
+  amrex::MultiFab& src = new_sources[forcing_src]->fill();
+  src.setVal(0.0);
 
-  if (!add_forcing_src) {
-    return;
+  if (add_forcing_src) {
+    fill_forcing_source(S_old, S_new, src, ng);
   }
-
-  fill_forcing_source(S_old, S_new, *new_sources[forcing_src], ng);
+  new_sources[forcing_src]->commit();
 }
 
 void
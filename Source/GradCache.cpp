@@ -0,0 +1,198 @@
+#include <AMReX_EBFArrayBox.H>
+
+#include "PelePhysics.H"
+#include "IndexDefines.H"
+#include "Derive.H"
+#include "GradCache.H"
+
+namespace pele::pelec {
+
+amrex::Vector<std::unique_ptr<GradientCache>> GradientCache::s_levels;
+bool GradientCache::s_enabled = false;
+
+namespace {
+
+// Quantities of group G in cell iv
+template <int G>
+AMREX_GPU_DEVICE AMREX_FORCE_INLINE void
+grad_vals(
+  const amrex::IntVect& iv,
+  amrex::Array4<const amrex::Real> const& dat,
+  amrex::Real vals[grad_nvals<G>()]) noexcept
+{
+  const amrex::Real rhoInv = 1.0 / dat(iv, URHO);
+  if constexpr (G == grad_vel) {
+    for (int a = 0; a < AMREX_SPACEDIM; a++) {
+      vals[a] = dat(iv, UMX + a) * rhoInv;
+    }
+  } else if constexpr (G == grad_temp) {
+    vals[0] = dat(iv, UTEMP);
+  } else {
+    amrex::Real massfrac[NUM_SPECIES];
+    for (int n = 0; n < NUM_SPECIES; n++) {
+      massfrac[n] = dat(iv, UFS + n) * rhoInv;
+    }
+    auto eos = pele::physics::PhysicsType::eos();
+    if constexpr (G == grad_pres) {
+      eos.RTY2P(dat(iv, URHO), dat(iv, UTEMP), massfrac, vals[0]);
+    } else if constexpr (G == grad_molefrac) {
+      eos.Y2X(massfrac, vals);
+    } else {
+      for (int n = 0; n < NUM_SPECIES; n++) {
+        vals[n] = massfrac[n];
+      }
+    }
+  }
+}
+
+} // namespace
+
+template <int G>
+void
+GradientCache::compute(
+  const amrex::Box& bx,
+  const amrex::FArrayBox& datfab,
+  const amrex::Geometry& geom,
+  amrex::FArrayBox& grad)
+{
+  constexpr int nvals = grad_nvals<G>();
+  grad.resize(bx, grad_ncomp<G>());
+
+  const auto& flag_fab = amrex::getEBCellFlagFab(datfab);
+  const auto& typ = flag_fab.getType(bx);
+  if (typ == amrex::FabType::covered) {
+    grad.setVal<amrex::RunOn::Device>(0.0, bx);
+    return;
+  }
+  const auto& flags = flag_fab.const_array();
+  const bool all_regular = typ == amrex::FabType::regular;
+  const auto dxinv = geom.InvCellSizeArray();
+  auto const dat = datfab.const_array();
+  auto const g = grad.array();
+
+  amrex::ParallelFor(bx, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
+    const amrex::IntVect iv(AMREX_D_DECL(i, j, k));
+    amrex::Real vm[nvals];
+    amrex::Real vp[nvals];
+    for (int d = 0; d < AMREX_SPACEDIM; d++) {
+      int im;
+      int ip;
+      get_idx(iv[d], d, all_regular, flags(iv), im, ip);
+      amrex::IntVect ivm(iv);
+      amrex::IntVect ivp(iv);
+      ivm[d] = im;
+      ivp[d] = ip;
+      grad_vals<G>(ivm, dat, vm);
+      grad_vals<G>(ivp, dat, vp);
+      const amrex::Real w = get_weight(im, ip) * dxinv[d];
+      for (int v = 0; v < nvals; v++) {
+        g(iv, grad_comp(v, d)) = w * (vp[v] - vm[v]);
+      }
+    }
+  });
+}
+
+template <int G>
+const amrex::FArrayBox&
+GradientCache::get(
+  const amrex::Box& bx,
+  const amrex::FArrayBox& datfab,
+  const amrex::Geometry& geom,
+  amrex::Real time)
+{
+  // Boxes are disjoint within a derive, so a box is only computed by the
+  // thread that requests it
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_valid || (time != m_time)) {
+      amrex::Gpu::streamSynchronize();
+      m_fabs.clear();
+      m_valid = true;
+      m_time = time;
+    }
+    const auto it = m_fabs.find(bx);
+    if ((it != m_fabs.end()) && it->second[G]) {
+      return *(it->second[G]);
+    }
+  }
+
+  auto fab = std::make_unique<amrex::FArrayBox>(
+    bx, grad_ncomp<G>(), amrex::The_Arena());
+  compute<G>(bx, datfab, geom, *fab);
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+  auto& slot = m_fabs[bx][G];
+  slot = std::move(fab);
+  return *slot;
+}
+
+void
+GradientCache::clear()
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  amrex::Gpu::streamSynchronize();
+  m_fabs.clear();
+  m_valid = false;
+}
+
+void
+GradientCache::clearAll()
+{
+  for (auto& cache : s_levels) {
+    if (cache) {
+      cache->clear();
+    }
+  }
+}
+
+GradientCache&
+GradientCache::level(int lev)
+{
+  // First called when the level is built, outside of the threaded derives
+  if (lev >= static_cast<int>(s_levels.size())) {
+    s_levels.resize(lev + 1);
+  }
+  if (!s_levels[lev]) {
+    s_levels[lev] = std::make_unique<GradientCache>();
+  }
+  return *s_levels[lev];
+}
+
+template <int G>
+const amrex::FArrayBox&
+GradientCache::fetch(
+  const amrex::Box& bx,
+  const amrex::FArrayBox& datfab,
+  const amrex::Geometry& geom,
+  amrex::Real time,
+  int lev,
+  amrex::FArrayBox& scratch)
+{
+  if (s_enabled) {
+    return level(lev).get<G>(bx, datfab, geom, time);
+  }
+  scratch.resize(bx, grad_ncomp<G>(), amrex::The_Async_Arena());
+  compute<G>(bx, datfab, geom, scratch);
+  return scratch;
+}
+
+#define PELEC_GRAD_CACHE_INSTANTIATE(G)                                        \
+  template const amrex::FArrayBox& GradientCache::get<G>(                      \
+    const amrex::Box&, const amrex::FArrayBox&, const amrex::Geometry&,        \
+    amrex::Real);                                                              \
+  template void GradientCache::compute<G>(                                     \
+    const amrex::Box&, const amrex::FArrayBox&, const amrex::Geometry&,        \
+    amrex::FArrayBox&);                                                        \
+  template const amrex::FArrayBox& GradientCache::fetch<G>(                    \
+    const amrex::Box&, const amrex::FArrayBox&, const amrex::Geometry&,        \
+    amrex::Real, int, amrex::FArrayBox&);
+
+PELEC_GRAD_CACHE_INSTANTIATE(grad_vel)
+PELEC_GRAD_CACHE_INSTANTIATE(grad_temp)
+PELEC_GRAD_CACHE_INSTANTIATE(grad_pres)
+PELEC_GRAD_CACHE_INSTANTIATE(grad_molefrac)
+PELEC_GRAD_CACHE_INSTANTIATE(grad_massfrac)
+
+#undef PELEC_GRAD_CACHE_INSTANTIATE
+
+} // namespace pele::pelec
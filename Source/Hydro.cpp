@@ -1,4 +1,5 @@
 #include "Hydro.H"
+#include "PerfCounters.H"
 
 // Set up the source terms to go into the hydro.
 void
@@ -18,6 +19,11 @@ PeleC::construct_hydro_source(
     hydro_source.setVal(0);
   } else {
     BL_PROFILE("PeleC::advance_hydro_pc_umdrv()");
+    const amrex::Long ncells = grids.numPts();
+    pele::pelec::PerfTimer perf_timer(
+      level, pele::pelec::perf_hydro, ncells,
+      ncells * (3 * NVAR + 2 * QVAR + NQAUX) *
+        static_cast<amrex::Long>(sizeof(amrex::Real)));
 
     if ((verbose != 0) && amrex::ParallelDescriptor::IOProcessor()) {
       amrex::Print() << "... Computing hydro advance" << std::endl;
@@ -28,10 +34,8 @@ PeleC::construct_hydro_source(
     int ng = 0; // TODO: This is currently the largest ngrow of the source
                 // data...maybe this needs fixing?
     for (int n = 0; n < src_list.size(); ++n) {
-      amrex::MultiFab::Saxpy(
-        sources_for_hydro, 0.5, *new_sources[src_list[n]], 0, 0, NVAR, ng);
-      amrex::MultiFab::Saxpy(
-        sources_for_hydro, 0.5, *old_sources[src_list[n]], 0, 0, NVAR, ng);
+      new_sources[src_list[n]]->saxpy(sources_for_hydro, 0.5, ng);
+      old_sources[src_list[n]]->saxpy(sources_for_hydro, 0.5, ng);
     }
     // Add I_R terms to advective forcing
     if (do_react) {
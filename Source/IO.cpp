@@ -19,6 +19,9 @@
 #include "PeleC.H"
 #include "IO.H"
 #include "IndexDefines.H"
+#include "PerfCounters.H"
+#include "DeltaCheckpoint.H"
+#include "PltCompress.H"
 
 #ifdef PELEC_USE_SPRAY
 #include "SprayParticles.H"
@@ -113,6 +116,62 @@ PeleC::restart(amrex::Amr& papa, std::istream& is, bool bReadSpecial)
       get_new_data(i).setVal(0.0);
     }
   }
+
+  // Restart the statistics if the sampled fields changed since the checkpoint
+  bool stats_reset = false;
+  if (get_new_data(Stats_Type).nComp() != desc_lst[Stats_Type].nComp()) {
+    stats_reset = true;
+    amrex::Print() << "Statistics in checkpoint do not match pelec.stats_vars "
+                      "and pelec.stats_correlations, resetting them at level "
+                   << level << std::endl;
+    const amrex::Real ctime = state[State_Type].curTime();
+    state[Stats_Type].define(
+      geom.Domain(), grids, dmap, desc_lst[Stats_Type], ctime,
+      parent->dtLevel(level), Factory());
+    get_new_data(Stats_Type).setVal(0.0);
+  }
+
+  // Bring the state to the time of the last incremental checkpoint
+  if (!restart_delta.empty()) {
+    amrex::Vector<int> types;
+    amrex::Vector<amrex::MultiFab*> mfs;
+    for (int typ = 0; typ < desc_lst.size(); typ++) {
+      if (
+        desc_lst[typ].store_in_checkpoint() &&
+        (state_in_checkpoint[typ] == 1) &&
+        !((typ == Stats_Type) && stats_reset)) {
+        types.push_back(typ);
+        mfs.push_back(&get_new_data(typ));
+      }
+    }
+    int steps = 0;
+    amrex::Real time = 0.0;
+    amrex::Real dt = 0.0;
+    pele::pelec::DeltaCheckpoint::restore(
+      restart_delta, papa.theRestartFile(), level, types, mfs, steps, time,
+      dt);
+    for (int typ = 0; typ < desc_lst.size(); typ++) {
+      state[typ].setTimeLevel(time, dt, dt);
+      if (state[typ].hasOldData()) {
+        amrex::MultiFab::Copy(
+          get_old_data(typ), get_new_data(typ), 0, 0,
+          get_new_data(typ).nComp(), 0);
+      }
+    }
+    papa.setLevelSteps(level, steps);
+    papa.setDtLevel(dt, level);
+    if (level == 0) {
+      papa.setCumTime(time);
+    }
+  } else if (chk_delta_int > 0) {
+    amrex::Vector<int> types;
+    amrex::Vector<amrex::MultiFab*> mfs;
+    checkpoint_state(types, mfs);
+    const amrex::Vector<const amrex::MultiFab*> cmfs(mfs.begin(), mfs.end());
+    pele::pelec::DeltaCheckpoint::setReference(
+      level, papa.theRestartFile(), "", types, cmfs);
+  }
+
   buildMetrics();
 
   init_eb();
@@ -122,10 +181,17 @@ PeleC::restart(amrex::Amr& papa, std::istream& is, bool bReadSpecial)
   for (int n = 0; n < src_list.size(); ++n) {
     int oldGrow = numGrow();
     int newGrow = S_new.nGrow();
-    old_sources[src_list[n]] = std::make_unique<amrex::MultiFab>(
-      grids, dmap, NVAR, oldGrow, amrex::MFInfo(), Factory());
-    new_sources[src_list[n]] = std::make_unique<amrex::MultiFab>(
-      grids, dmap, NVAR, newGrow, amrex::MFInfo(), Factory());
+    // The spray source is deposited by the particles in double precision
+    const bool single = mixed_precision && (src_list[n] != spray_src);
+    auto* scratch = single ? &mixed_precision_scratch : nullptr;
+    old_sources[src_list[n]] =
+      std::make_unique<pele::pelec::MixedPrecisionMF>();
+    old_sources[src_list[n]]->define(
+      grids, dmap, NVAR, oldGrow, Factory(), scratch);
+    new_sources[src_list[n]] =
+      std::make_unique<pele::pelec::MixedPrecisionMF>();
+    new_sources[src_list[n]]->define(
+      grids, dmap, NVAR, newGrow, Factory(), scratch);
   }
 
   if (do_hydro || do_diffuse) {
@@ -242,6 +308,15 @@ PeleC::set_state_in_checkpoint(amrex::Vector<int>& state_in_checkpoint)
     } else if (i == Work_Estimate_Type) {
       // Never use work estimate checkpoint
       state_in_checkpoint[i] = 0;
+    } else if (i == Stats_Type) {
+      if (!do_stats) {
+        state_in_checkpoint[i] = 0;
+      } else {
+        state_in_checkpoint[i] = is_present ? 1 : 0;
+      }
+    } else if (i == Entropy_Type) {
+      // Recomputed in the next advance
+      state_in_checkpoint[i] = 0;
     } else {
       amrex::Abort("Unknown StateType");
     }
@@ -255,6 +330,12 @@ PeleC::checkPoint(
   amrex::VisMF::How how,
   bool /*dump_old_default*/)
 {
+  const amrex::Long ncells = grids.numPts();
+  pele::pelec::PerfTimer perf_timer(
+    level, pele::pelec::perf_io, ncells,
+    ncells * get_new_data(State_Type).nComp() *
+      static_cast<amrex::Long>(sizeof(amrex::Real)));
+
   amrex::AmrLevel::checkPoint(dir, os, how, dump_old);
 
 #ifdef PELEC_USE_SPRAY
@@ -330,6 +411,69 @@ PeleC::checkPoint(
       BodyFile.close();
     }
   }
+
+  // Reference of the next incremental checkpoint
+  if (chk_delta_int > 0) {
+    amrex::Vector<int> types;
+    amrex::Vector<amrex::MultiFab*> mfs;
+    checkpoint_state(types, mfs);
+    const amrex::Vector<const amrex::MultiFab*> cmfs(mfs.begin(), mfs.end());
+    pele::pelec::DeltaCheckpoint::setReference(level, dir, "", types, cmfs);
+  }
+}
+
+void
+PeleC::checkpoint_state(
+  amrex::Vector<int>& types, amrex::Vector<amrex::MultiFab*>& mfs)
+{
+  for (int typ = 0; typ < desc_lst.size(); typ++) {
+    if (desc_lst[typ].store_in_checkpoint()) {
+      types.push_back(typ);
+      mfs.push_back(&get_new_data(typ));
+    }
+  }
+}
+
+void
+PeleC::writeDeltaCheckpoint(const int nstep, const amrex::Real time)
+{
+  BL_PROFILE("PeleC::writeDeltaCheckpoint()");
+  AMREX_ASSERT(level == 0);
+
+  const int finest_level = parent->finestLevel();
+  amrex::Vector<pele::pelec::DeltaLevel> levels(finest_level + 1);
+  amrex::Long ncells = 0;
+  for (int lev = 0; lev <= finest_level; lev++) {
+    auto& dl = levels[lev];
+    dl.steps = parent->levelSteps(lev);
+    dl.dt = parent->dtLevel(lev);
+    amrex::Vector<amrex::MultiFab*> mfs;
+    getLevel(lev).checkpoint_state(dl.types, mfs);
+    dl.mfs.assign(mfs.begin(), mfs.end());
+    ncells += parent->boxArray(lev).numPts();
+  }
+
+  // The particles and new grids need a full checkpoint
+  bool full = !pele::pelec::DeltaCheckpoint::hasReferences(levels);
+#ifdef PELEC_USE_SPRAY
+  full = full || (SprayPC != nullptr);
+#endif
+  if (full) {
+    if (verbose > 0) {
+      amrex::Print() << "Writing a full checkpoint instead of a delta"
+                     << std::endl;
+    }
+    parent->checkPoint();
+    return;
+  }
+
+  const auto wall0 = pele::pelec::PerfCounters::wtime();
+  const amrex::Long bytes = pele::pelec::DeltaCheckpoint::write(
+    amrex::Concatenate(chk_delta_file, nstep, 5), nstep, time, levels,
+    chk_delta_tol, verbose > 0);
+  pele::pelec::PerfCounters::add(
+    0, pele::pelec::perf_io, pele::pelec::PerfCounters::wtime() - wall0,
+    ncells, bytes);
 }
 
 void
@@ -357,6 +501,12 @@ PeleC::setPlotVariables()
     }
   }
 
+  if (!do_stats) {
+    for (int i = 0; i < desc_lst[Stats_Type].nComp(); i++) {
+      amrex::Amr::deleteStatePlotVar(desc_lst[Stats_Type].name(i));
+    }
+  }
+
   bool plot_rhoy = true;
   pp.query("plot_rhoy", plot_rhoy);
   if (plot_rhoy) {
@@ -781,8 +931,29 @@ PeleC::initLevelDataFromPlt(
 {
   amrex::Print() << "Using data (rho, u, T, Y) from pltfile " << dataPltFile
                  << std::endl;
-  pele::physics::pltfilemanager::PltFileManager pltData(dataPltFile);
-  const auto plt_vars = pltData.getVariableList();
+
+  // Native or compressed (pelec.plot_compression) plotfile
+  std::unique_ptr<pele::physics::pltfilemanager::PltFileManager> pltNative;
+  std::unique_ptr<pele::pelec::CompressedPltFile> pltCompressed;
+  amrex::Vector<std::string> plt_vars;
+  if (pele::pelec::CompressedPltFile::isCompressed(dataPltFile)) {
+    pltCompressed =
+      std::make_unique<pele::pelec::CompressedPltFile>(dataPltFile);
+    plt_vars = pltCompressed->getVariableList();
+  } else {
+    pltNative =
+      std::make_unique<pele::physics::pltfilemanager::PltFileManager>(
+        dataPltFile);
+    plt_vars = pltNative->getVariableList();
+  }
+  auto fillPatchFromPlt = [&](int pltComp, int dataComp, int nComp) {
+    if (pltCompressed) {
+      pltCompressed->fillPatchFromPlt(
+        lev, geom, pltComp, dataComp, nComp, S_new);
+    } else {
+      pltNative->fillPatchFromPlt(lev, geom, pltComp, dataComp, nComp, S_new);
+    }
+  };
 
   // Read rho, u, temperature (required)
   std::map<std::string, int> vars{
@@ -793,17 +964,16 @@ PeleC::initLevelDataFromPlt(
       amrex::Abort("Unable to find variable in plot file: " + var.first);
     }
   }
-  pltData.fillPatchFromPlt(lev, geom, vars["density"], URHO, 1, S_new);
-  pltData.fillPatchFromPlt(
-    lev, geom, vars["x_velocity"], UMX, AMREX_SPACEDIM, S_new);
-  pltData.fillPatchFromPlt(lev, geom, vars["Temp"], UTEMP, 1, S_new);
+  fillPatchFromPlt(vars["density"], URHO, 1);
+  fillPatchFromPlt(vars["x_velocity"], UMX, AMREX_SPACEDIM);
+  fillPatchFromPlt(vars["Temp"], UTEMP, 1);
 
   // Copy species from the plot file
   for (int n = 0; n < spec_names.size(); n++) {
     const auto& spec = spec_names.at(n);
     const int pos = find_position(plt_vars, "Y(" + spec + ")");
     if (pos != -1) {
-      pltData.fillPatchFromPlt(lev, geom, pos, UFS + n, 1, S_new);
+      fillPatchFromPlt(pos, UFS + n, 1);
     }
   }
 
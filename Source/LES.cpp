@@ -59,16 +59,18 @@ PeleC::construct_old_les_source(
       grids, dmap, NVAR, old_sources[les_src]->nGrow(), amrex::MFInfo(),
       Factory());
     old_sources[les_src]->define(
-      grids, dmap, NVAR, old_sources[les_src]->nGrow() + nGrowF,
-      amrex::MFInfo(), Factory());
+      grids, dmap, NVAR, old_sources[les_src]->nGrow() + nGrowF, Factory(),
+      old_sources[les_src]->isSingle() ? &mixed_precision_scratch : nullptr);
   }
 
-  old_sources[les_src]->setVal(0.0);
+  amrex::MultiFab& src = old_sources[les_src]->fill();
+  src.setVal(0.0);
 
   amrex::Real flux_factor_old = 0.5;
-  getLESTerm(time, dt, *old_sources[les_src], flux_factor_old);
+  getLESTerm(time, dt, src, flux_factor_old);
 
-  old_sources[les_src]->FillBoundary(geom.periodicity());
+  src.FillBoundary(geom.periodicity());
+  old_sources[les_src]->commit();
 }
 
 void
@@ -81,14 +83,16 @@ PeleC::construct_new_les_source(
       grids, dmap, NVAR, new_sources[les_src]->nGrow(), amrex::MFInfo(),
       Factory());
     new_sources[les_src]->define(
-      grids, dmap, NVAR, new_sources[les_src]->nGrow() + nGrowF,
-      amrex::MFInfo(), Factory());
+      grids, dmap, NVAR, new_sources[les_src]->nGrow() + nGrowF, Factory(),
+      new_sources[les_src]->isSingle() ? &mixed_precision_scratch : nullptr);
   }
 
-  new_sources[les_src]->setVal(0.0);
+  amrex::MultiFab& src = new_sources[les_src]->fill();
+  src.setVal(0.0);
 
   amrex::Real flux_factor_new = sub_iteration == sub_ncycle - 1 ? 0.5 : 0;
-  getLESTerm(time, dt, *new_sources[les_src], flux_factor_new);
+  getLESTerm(time, dt, src, flux_factor_new);
+  new_sources[les_src]->commit();
 }
 
 // Calculate the LES term by calling an SFS model
@@ -17,11 +17,13 @@ PeleC::construct_old_mms_source(amrex::Real time)
 
   int ng = 0; // None filled
 
-  old_sources[mms_src]->setVal(0.0);
+  amrex::MultiFab& src = old_sources[mms_src]->fill();
+  src.setVal(0.0);
 
-  fill_mms_source(time, S_old, *old_sources[mms_src], ng);
+  fill_mms_source(time, S_old, src, ng);
 
-  old_sources[mms_src]->FillBoundary(geom.periodicity());
+  src.FillBoundary(geom.periodicity());
+  old_sources[mms_src]->commit();
 }
 
 void
@@ -31,9 +33,11 @@ PeleC::construct_new_mms_source(amrex::Real time)
 
   int ng = 0;
 
-  new_sources[mms_src]->setVal(0.0);
+  amrex::MultiFab& src = new_sources[mms_src]->fill();
+  src.setVal(0.0);
 
-  fill_mms_source(time, S_old, *new_sources[mms_src], ng);
+  fill_mms_source(time, S_old, src, ng);
+  new_sources[mms_src]->commit();
 }
 
 void
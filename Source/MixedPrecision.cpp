@@ -0,0 +1,114 @@
+#include "MixedPrecision.H"
+
+namespace pele::pelec {
+
+amrex::MultiFab&
+MixedPrecisionScratch::get(
+  const amrex::BoxArray& ba,
+  const amrex::DistributionMapping& dm,
+  int ncomp,
+  int ngrow,
+  const amrex::FabFactory<amrex::FArrayBox>& factory)
+{
+  if (
+    (m_mf == nullptr) || (m_mf->boxArray() != ba) ||
+    (m_mf->DistributionMap() != dm) || (m_mf->nComp() != ncomp) ||
+    (m_mf->nGrow() < ngrow)) {
+    m_mf = std::make_unique<amrex::MultiFab>(
+      ba, dm, ncomp, ngrow, amrex::MFInfo(), factory);
+  }
+  return *m_mf;
+}
+
+void
+MixedPrecisionMF::define(
+  const amrex::BoxArray& ba,
+  const amrex::DistributionMapping& dm,
+  int ncomp,
+  int ngrow,
+  const amrex::FabFactory<amrex::FArrayBox>& factory,
+  MixedPrecisionScratch* scratch)
+{
+  m_factory = &factory;
+  m_scratch = scratch;
+  m_filled = nullptr;
+  m_double.reset();
+  m_float.reset();
+  if (scratch != nullptr) {
+    m_float = std::make_unique<FloatMultiFab>(ba, dm, ncomp, ngrow);
+    m_float->setVal(0.0F);
+  } else {
+    m_double = std::make_unique<amrex::MultiFab>(
+      ba, dm, ncomp, ngrow, amrex::MFInfo(), factory);
+  }
+}
+
+int
+MixedPrecisionMF::nGrow() const
+{
+  return isSingle() ? m_float->nGrow() : m_double->nGrow();
+}
+
+amrex::MultiFab&
+MixedPrecisionMF::fill()
+{
+  if (!isSingle()) {
+    return *m_double;
+  }
+  m_filled = &m_scratch->get(
+    m_float->boxArray(), m_float->DistributionMap(), m_float->nComp(),
+    m_float->nGrow(), *m_factory);
+  m_filled->setVal(0.0);
+  return *m_filled;
+}
+
+void
+MixedPrecisionMF::commit()
+{
+  if (!isSingle() || (m_filled == nullptr)) {
+    return;
+  }
+  BL_PROFILE("MixedPrecisionMF::commit()");
+  // The scratch may have been redefined by the caller
+  AMREX_ASSERT(m_filled->nGrow() >= m_float->nGrow());
+  auto const& src = m_filled->const_arrays();
+  auto const& dst = m_float->arrays();
+  amrex::ParallelFor(
+    *m_float, m_float->nGrowVect(), m_float->nComp(),
+    [=] AMREX_GPU_DEVICE(int nbx, int i, int j, int k, int n) noexcept {
+      dst[nbx](i, j, k, n) = static_cast<float>(src[nbx](i, j, k, n));
+    });
+  m_filled = nullptr;
+}
+
+void
+MixedPrecisionMF::saxpy(amrex::MultiFab& dst, amrex::Real a, int ng) const
+{
+  if (!isSingle()) {
+    amrex::MultiFab::Saxpy(dst, a, *m_double, 0, 0, dst.nComp(), ng);
+    return;
+  }
+  AMREX_ASSERT(m_filled == nullptr);
+  AMREX_ASSERT(m_float->nComp() >= dst.nComp());
+  AMREX_ASSERT(m_float->nGrow() >= ng);
+  auto const& src = m_float->const_arrays();
+  auto const& d = dst.arrays();
+  amrex::ParallelFor(
+    dst, amrex::IntVect(ng), dst.nComp(),
+    [=] AMREX_GPU_DEVICE(int nbx, int i, int j, int k, int n) noexcept {
+      d[nbx](i, j, k, n) += a * static_cast<amrex::Real>(src[nbx](i, j, k, n));
+    });
+}
+
+void
+MixedPrecisionMF::copy(const MixedPrecisionMF& src)
+{
+  AMREX_ASSERT(isSingle() == src.isSingle());
+  if (isSingle()) {
+    amrex::Copy(*m_float, *src.m_float, 0, 0, m_float->nComp(), 0);
+  } else {
+    amrex::MultiFab::Copy(*m_double, *src.m_double, 0, 0, m_double->nComp(), 0);
+  }
+}
+
+} // namespace pele::pelec
@@ -1,4 +1,5 @@
 #include "PeleC.H"
+#include "PerfCounters.H"
 #include "SprayParticles.H"
 
 namespace {
@@ -237,7 +238,21 @@ PeleC::particleMKD(
   if (sub_iteration != 0) {
     return;
   }
-  old_sources[spray_src]->setVal(0.);
+  particleMKDSetup();
+  {
+    pele::pelec::PerfTimer perf_timer(
+      level, pele::pelec::perf_spray, grids.numPts(), 0);
+    particleMKDMove(time, dt, amr_ncycle);
+  }
+  pele::pelec::PerfTimer perf_timer(
+    level, pele::pelec::perf_spray_merge, grids.numPts(), 0);
+  particleMKDTransfer();
+}
+
+void
+PeleC::particleMKDSetup()
+{
+  old_sources[spray_src]->fill().setVal(0.);
   tmp_spray_source.setVal(0.);
   // Setup ghost particles for use in finer levels. Note that ghost
   // particles that will be used by this level have already been created,
@@ -255,13 +270,19 @@ PeleC::particleMKD(
       level + 1, finest_level, finer_ref);
     setupGhostParticles(level, finest_level, ghost_width);
   }
+}
 
+void
+PeleC::particleMKDMove(amrex::Real time, amrex::Real dt, int amr_ncycle)
+{
+  BL_PROFILE("PeleC::particleMKDMove()");
   // Advance the particle velocities to the half-time and the positions to
   // the new time
   if (particle_verbose >= 1) {
     amrex::Print()
       << "moveKickDrift ... updating particle positions and velocity\n";
   }
+  const int finest_level = parent->finestLevel();
   const int spray_state_ghosts = sprayStateGhosts(amr_ncycle);
   const int spray_source_ghosts = tmp_spray_source.nGrow();
   auto const* ltransparm = PeleC::trans_parms.device_trans_parm();
@@ -289,10 +310,16 @@ PeleC::particleMKD(
       Sborder, tmp_spray_source, level, dt, time, false, true,
       spray_state_ghosts, spray_source_ghosts, true, ltransparm);
   }
+}
+
+void
+PeleC::particleMKDTransfer()
+{
   // Must call transfer source after moveKick and moveKickDrift
   // on all particle types
   SprayPC->transferSource(
-    spray_source_ghosts, level, tmp_spray_source, *old_sources[spray_src]);
+    tmp_spray_source.nGrow(), level, tmp_spray_source,
+    old_sources[spray_src]->fill());
 }
 
 void
@@ -308,7 +335,7 @@ PeleC::particleMK(
   }
   const int spray_state_ghosts = sprayStateGhosts(amr_ncycle);
   const int spray_source_ghosts = tmp_spray_source.nGrow();
-  new_sources[spray_src]->setVal(0.);
+  new_sources[spray_src]->fill().setVal(0.);
   auto const* ltransparm = PeleC::trans_parms.device_trans_parm();
   if (particle_verbose >= 1) {
     amrex::Print() << "moveKick ... updating velocity only\n";
@@ -329,7 +356,8 @@ PeleC::particleMK(
       spray_state_ghosts, spray_source_ghosts, ltransparm);
   }
   SprayPC->transferSource(
-    spray_source_ghosts, level, tmp_spray_source, *new_sources[spray_src]);
+    spray_source_ghosts, level, tmp_spray_source,
+    new_sources[spray_src]->fill());
 }
 
 void
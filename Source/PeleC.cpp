@@ -31,6 +31,8 @@ using namespace MASA;
 #include "Utilities.H"
 #include "Tagging.H"
 #include "IndexDefines.H"
+#include "PerfCounters.H"
+#include "GradCache.H"
 
 #ifdef PELEC_ENABLE_FPE_TRAP
 #if defined(__linux__)
@@ -44,7 +46,9 @@ bool PeleC::signalStopJob = false;
 int PeleC::verbose = 0;
 int PeleC::radius_grow = 1;
 amrex::BCRec PeleC::phys_bc;
+int PeleC::steady_bc_faces = 0;
 amrex::Real PeleC::frac_change = std::numeric_limits<amrex::Real>::max();
+amrex::Long PeleC::regrids_avoided = 0;
 int PeleC::Density = -1;
 int PeleC::Eden = -1;
 int PeleC::Eint = -1;
@@ -102,8 +106,12 @@ pele::physics::transport::TransportParams<
   PeleC::trans_parms;
 
 pele::physics::turbinflow::TurbInflow PeleC::turb_inflow;
+std::function<void(int, const amrex::Geometry&, const amrex::MultiFab&)>
+  PeleC::prob_init_level;
 amrex::Vector<std::unique_ptr<DiagBase>> PeleC::m_diagnostics;
 amrex::Vector<std::string> PeleC::m_diagVars;
+amrex::Vector<std::string> PeleC::stats_vars;
+amrex::Vector<int> PeleC::stats_corr;
 
 amrex::Vector<int> PeleC::src_list;
 
@@ -177,6 +185,8 @@ PeleC::read_params()
 
 #include "pelec_queries.H"
 
+  pele::pelec::GradientCache::setEnabled(derive_grad_cache);
+
   pp.query("v", verbose);
 
   // Get boundary conditions
@@ -232,6 +242,28 @@ PeleC::read_params()
     phys_bc.setHi(dir, hi_bc[dir]);
   }
 
+  const int nsteady = pp.countval("steady_bc_faces");
+  if (nsteady > 0) {
+    amrex::Vector<std::string> faces;
+    pp.getarr("steady_bc_faces", faces, 0, nsteady);
+    const std::string dirs = "xyz";
+    for (const auto& face : faces) {
+      const bool ok_size = face.size() == 3;
+      const auto dir = ok_size ? static_cast<int>(dirs.find(face[0])) : -1;
+      const std::string side = ok_size ? face.substr(1) : "";
+      if (
+        (dir < 0) || (dir >= AMREX_SPACEDIM) ||
+        ((side != "lo") && (side != "hi"))) {
+        amrex::Abort(
+          "pelec.steady_bc_faces can only contain xlo, xhi, ylo, yhi, zlo or "
+          "zhi");
+      }
+      const amrex::Orientation ori(
+        dir, side == "lo" ? amrex::Orientation::low : amrex::Orientation::high);
+      steady_bc_faces |= (1 << ori);
+    }
+  }
+
   typical_values_chem_usr.resize(NUM_SPECIES + 1, 1.0e-10);
   pp.query("use_typ_vals_chem", use_typical_vals_chem);
   pp.query("use_typ_vals_chem_usr", use_typical_vals_chem_usr);
@@ -339,6 +371,15 @@ PeleC::read_params()
     amrex::Error("Cannot have max_dt < fixed_dt");
   }
 
+  // The Newton iterations use the species polynomials of the mechanism,
+  // which only describe the ideal gas mixture EOS
+  if (
+    temp_newton &&
+    !std::is_same<
+      pele::physics::PhysicsType::eos_type, pele::physics::eos::Fuego>::value) {
+    amrex::Abort("pelec.temp_newton requires the Fuego equation of state");
+  }
+
 #ifdef PELEC_USE_SPRAY
   readSprayParams();
 #endif
@@ -405,10 +446,17 @@ PeleC::PeleC(
   for (int n = 0; n < src_list.size(); ++n) {
     int oldGrow = numGrow();
     int newGrow = S_new.nGrow();
-    old_sources[src_list[n]] = std::make_unique<amrex::MultiFab>(
-      grids, dmap, NVAR, oldGrow, amrex::MFInfo(), Factory());
-    new_sources[src_list[n]] = std::make_unique<amrex::MultiFab>(
-      grids, dmap, NVAR, newGrow, amrex::MFInfo(), Factory());
+    // The spray source is deposited by the particles in double precision
+    const bool single = mixed_precision && (src_list[n] != spray_src);
+    auto* scratch = single ? &mixed_precision_scratch : nullptr;
+    old_sources[src_list[n]] =
+      std::make_unique<pele::pelec::MixedPrecisionMF>();
+    old_sources[src_list[n]]->define(
+      grids, dmap, NVAR, oldGrow, Factory(), scratch);
+    new_sources[src_list[n]] =
+      std::make_unique<pele::pelec::MixedPrecisionMF>();
+    new_sources[src_list[n]]->define(
+      grids, dmap, NVAR, newGrow, Factory(), scratch);
   }
 
   int nGrowS = numGrow();
@@ -464,6 +512,11 @@ PeleC::PeleC(
   }
 
   get_new_data(Reactions_Type).setVal(0.0);
+  get_new_data(Stats_Type).setVal(0.0);
+  if (do_entropy_state) {
+    get_new_data(Entropy_Type).setVal(0.0);
+  }
+  entropy_state_valid = false;
 
   // Don't need this in pure C++?
   // initialize the Godunov state array used in hydro -- we wait
@@ -489,6 +542,8 @@ PeleC::PeleC(
   if (use_explicit_filter) {
     init_filters();
   }
+
+  pele::pelec::GradientCache::level(level).clear();
 }
 
 PeleC::~PeleC()
@@ -496,6 +551,7 @@ PeleC::~PeleC()
   if (do_react) {
     close_reactor();
   }
+  pele::pelec::GradientCache::level(level).clear();
 }
 
 void
@@ -634,13 +690,21 @@ PeleC::initData()
 {
   BL_PROFILE("PeleC::initData()");
 
+  pele::pelec::GradientCache::level(level).clear();
+
+  amrex::MultiFab& S_new = get_new_data(State_Type);
+
+  // Let the problem load level-dependent input data before the parameters
+  // are copied to the device
+  if (init_pltfile.empty() && prob_init_level) {
+    prob_init_level(level, geom, S_new);
+  }
+
   // Copy problem parameter structs to device
   amrex::Gpu::copy(
     amrex::Gpu::hostToDevice, PeleC::h_prob_parm_device,
     PeleC::h_prob_parm_device + 1, PeleC::d_prob_parm_device);
 
-  amrex::MultiFab& S_new = get_new_data(State_Type);
-
   S_new.setVal(0.0);
 
 #if AMREX_SPACEDIM > 1
@@ -661,6 +725,11 @@ PeleC::initData()
   }
 
   get_new_data(Reactions_Type).setVal(0.0);
+  get_new_data(Stats_Type).setVal(0.0);
+  if (do_entropy_state) {
+    get_new_data(Entropy_Type).setVal(0.0);
+  }
+  entropy_state_valid = false;
 
   if (do_mol_load_balance || do_react_load_balance) {
     get_new_data(Work_Estimate_Type).setVal(1.0);
@@ -716,6 +785,7 @@ PeleC::init(AmrLevel& old)
   amrex::Real prev_time = oldlev->state[State_Type].prevTime();
   amrex::Real dt_old = cur_time - prev_time;
   setTimeLevel(cur_time, dt_old, dt_new);
+  pele::pelec::GradientCache::level(level).clear();
 
   amrex::MultiFab& S_new = get_new_data(State_Type);
   FillPatch(old, S_new, 0, cur_time, State_Type, 0, NVAR);
@@ -735,6 +805,19 @@ PeleC::init(AmrLevel& old)
       old, work_estimate_new, 0, cur_time, Work_Estimate_Type, 0,
       work_estimate_new.nComp());
   }
+
+  amrex::MultiFab& Stats_new = get_new_data(Stats_Type);
+  if (do_stats) {
+    FillPatch(old, Stats_new, 0, cur_time, Stats_Type, 0, Stats_new.nComp());
+  } else {
+    Stats_new.setVal(0);
+  }
+
+  if (do_entropy_state) {
+    amrex::MultiFab& Ent_new = get_new_data(Entropy_Type);
+    FillPatch(old, Ent_new, 0, cur_time, Entropy_Type, 0, Ent_new.nComp());
+    entropy_state_valid = static_cast<PeleC&>(old).entropy_state_valid;
+  }
 }
 
 void
@@ -752,6 +835,7 @@ PeleC::init()
     (cur_time - prev_time) / (amrex::Real)parent->MaxRefRatio(level - 1);
 
   setTimeLevel(cur_time, dt_old, dt);
+  pele::pelec::GradientCache::level(level).clear();
   amrex::MultiFab& S_new = get_new_data(State_Type);
   FillCoarsePatch(S_new, 0, cur_time, State_Type, 0, NVAR);
 
@@ -761,6 +845,19 @@ PeleC::init()
     FillCoarsePatch(
       work_estimate_new, 0, cur_time, Work_Estimate_Type, 0, ncomp);
   }
+
+  amrex::MultiFab& Stats_new = get_new_data(Stats_Type);
+  if (do_stats) {
+    FillCoarsePatch(Stats_new, 0, cur_time, Stats_Type, 0, Stats_new.nComp());
+  } else {
+    Stats_new.setVal(0);
+  }
+
+  if (do_entropy_state) {
+    amrex::MultiFab& Ent_new = get_new_data(Entropy_Type);
+    FillCoarsePatch(Ent_new, 0, cur_time, Entropy_Type, 0, Ent_new.nComp());
+    entropy_state_valid = getLevel(level - 1).entropy_state_valid;
+  }
 }
 
 amrex::Real
@@ -793,9 +890,8 @@ PeleC::estTimeStep(amrex::Real /*dt_old*/)
 
   const amrex::MultiFab& stateMF = get_new_data(State_Type);
 
-  const amrex::Real* dx = geom.CellSize();
-
   std::string limiter = "pelec.max_dt";
+  dt_limiter_cell = amrex::IntVect(AMREX_D_DECL(-1, -1, -1));
 
   // Start the hydro with the max_dt value, but divide by CFL
   // to account for the fact that we multiply by it at the end.
@@ -803,81 +899,53 @@ PeleC::estTimeStep(amrex::Real /*dt_old*/)
   // criterion, we will get exactly max_dt for a timestep.
 
   const amrex::Real max_dt_over_cfl = max_dt / cfl;
-  amrex::Real estdt_hydro = max_dt_over_cfl;
-  amrex::Real estdt_vdif = max_dt_over_cfl;
-  amrex::Real estdt_tdif = max_dt_over_cfl;
-  amrex::Real estdt_edif = max_dt_over_cfl;
-  if (do_hydro || do_mol || diffuse_vel || diffuse_temp || diffuse_enth) {
+  EstDtTerms terms;
+  terms.hydro = do_hydro;
+  terms.veldif = diffuse_vel;
+  terms.tempdif = diffuse_temp;
+  terms.enthdif = diffuse_enth;
+  if (terms.hydro || terms.veldif || terms.tempdif || terms.enthdif) {
 
     auto const& fact =
       dynamic_cast<amrex::EBFArrayBoxFactory const&>(stateMF.Factory());
-    auto const& flags = fact.getMultiEBCellFlagFab();
+    auto const& flag_arrs = fact.getMultiEBCellFlagFab().const_arrays();
+    auto const& s_arrs = stateMF.const_arrays();
+    const auto dx = geom.CellSizeArray();
+    auto const* ltransparm = trans_parms.device_trans_parm();
 
     prefetchToDevice(stateMF); // This should accelerate the below operations.
-    amrex::Real AMREX_D_DECL(dx1 = dx[0], dx2 = dx[1], dx3 = dx[2]);
-
-    if (do_hydro) {
-      amrex::Real dt = amrex::ReduceMin(
-        stateMF, flags, 0,
-        [=] AMREX_GPU_HOST_DEVICE(
-          amrex::Box const& bx, const amrex::Array4<const amrex::Real>& fab_arr,
-          const amrex::Array4<const amrex::EBCellFlag>& flag_arr)
-          -> amrex::Real {
-          return pc_estdt_hydro(
-            bx, fab_arr, flag_arr, AMREX_D_DECL(dx1, dx2, dx3));
-        });
-      estdt_hydro = amrex::min<amrex::Real>(estdt_hydro, dt);
-    }
-
-    if (diffuse_vel) {
-      auto const* ltransparm = trans_parms.device_trans_parm();
-      amrex::Real dt = amrex::ReduceMin(
-        stateMF, flags, 0,
-        [=] AMREX_GPU_HOST_DEVICE(
-          amrex::Box const& bx, const amrex::Array4<const amrex::Real>& fab_arr,
-          const amrex::Array4<const amrex::EBCellFlag>& flag_arr)
-          -> amrex::Real {
-          return pc_estdt_veldif(
-            bx, fab_arr, flag_arr, AMREX_D_DECL(dx1, dx2, dx3), ltransparm);
-        });
-      estdt_vdif = amrex::min<amrex::Real>(estdt_vdif, dt);
-    }
 
-    if (diffuse_temp) {
-      auto const* ltransparm = trans_parms.device_trans_parm();
-      amrex::Real dt = amrex::ReduceMin(
-        stateMF, flags, 0,
-        [=] AMREX_GPU_HOST_DEVICE(
-          amrex::Box const& bx, const amrex::Array4<const amrex::Real>& fab_arr,
-          const amrex::Array4<const amrex::EBCellFlag>& flag_arr)
-          -> amrex::Real {
-          return pc_estdt_tempdif(
-            bx, fab_arr, flag_arr, AMREX_D_DECL(dx1, dx2, dx3), ltransparm);
-        });
-      estdt_tdif = amrex::min<amrex::Real>(estdt_tdif, dt);
+    // All limiters in a single pass over the cells (one transport evaluation
+    // per cell) and a single MPI reduction
+    using Min = amrex::ReduceOpMin;
+    using R = amrex::Real;
+    const auto mins = amrex::ParReduce(
+      amrex::TypeList<Min, Min, Min, Min>{}, amrex::TypeList<R, R, R, R>{},
+      stateMF, amrex::IntVect(0),
+      [=] AMREX_GPU_DEVICE(int nbx, int i, int j, int k) noexcept
+      -> amrex::GpuTuple<R, R, R, R> {
+        amrex::Real dt[dtlim_num];
+        pc_estdt(
+          i, j, k, s_arrs[nbx], flag_arrs[nbx], dx, terms, ltransparm, dt);
+        return {dt[0], dt[1], dt[2], dt[3]};
+      });
+    amrex::Real estdt_lim[dtlim_num] = {
+      amrex::get<0>(mins), amrex::get<1>(mins), amrex::get<2>(mins),
+      amrex::get<3>(mins)};
+    for (amrex::Real& dt : estdt_lim) {
+      dt = amrex::min<amrex::Real>(dt, max_dt_over_cfl);
     }
+    amrex::ParallelDescriptor::ReduceRealMin(estdt_lim, dtlim_num);
 
-    if (diffuse_enth) {
-      auto const* ltransparm = trans_parms.device_trans_parm();
-      amrex::Real dt = amrex::ReduceMin(
-        stateMF, flags, 0,
-        [=] AMREX_GPU_HOST_DEVICE(
-          amrex::Box const& bx, const amrex::Array4<const amrex::Real>& fab_arr,
-          const amrex::Array4<const amrex::EBCellFlag>& flag_arr)
-          -> amrex::Real {
-          return pc_estdt_enthdif(
-            bx, fab_arr, flag_arr, AMREX_D_DECL(dx1, dx2, dx3), ltransparm);
-        });
-      estdt_edif = amrex::min<amrex::Real>(estdt_edif, dt);
+    int ilim = dtlim_hydro;
+    for (int n = 1; n < dtlim_num; n++) {
+      if (estdt_lim[n] < estdt_lim[ilim]) {
+        ilim = n;
+      }
     }
-
-    estdt_hydro = amrex::min<amrex::Real>(
-      estdt_hydro,
-      amrex::min<amrex::Real>(
-        estdt_vdif, amrex::min<amrex::Real>(estdt_tdif, estdt_edif)));
-
-    amrex::ParallelDescriptor::ReduceRealMin(estdt_hydro);
-    estdt_hydro *= cfl;
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(
+      estdt_lim[ilim] > 0.0, "ERROR: dt needs to be positive.");
+    const amrex::Real estdt_hydro = estdt_lim[ilim] * cfl;
 
     if (verbose != 0) {
       amrex::Print() << "...estimated hydro-limited timestep at level " << level
@@ -886,8 +954,34 @@ PeleC::estTimeStep(amrex::Real /*dt_old*/)
 
     // Determine if this is more restrictive than the maximum timestep limiting
     if (estdt_hydro < estdt) {
-      limiter = "hydro";
+      const amrex::Vector<std::string> names = {
+        "hydro", "velocity diffusion", "temperature diffusion",
+        "enthalpy diffusion"};
+      limiter = names[ilim];
       estdt = estdt_hydro;
+
+      // Only worth a second pass when it is reported: lowest cell (in the
+      // index space of the domain) attaining the minimum of the limiter
+      if (verbose != 0) {
+        const amrex::Box& domain = geom.Domain();
+        const amrex::Real dtlim = estdt_lim[ilim];
+        const amrex::Long nomatch = std::numeric_limits<amrex::Long>::max();
+        amrex::Long loc = amrex::ParReduce(
+          amrex::TypeList<amrex::ReduceOpMin>{}, amrex::TypeList<amrex::Long>{},
+          stateMF, amrex::IntVect(0),
+          [=] AMREX_GPU_DEVICE(int nbx, int i, int j, int k) noexcept
+          -> amrex::GpuTuple<amrex::Long> {
+            amrex::Real dt[dtlim_num];
+            pc_estdt(
+              i, j, k, s_arrs[nbx], flag_arrs[nbx], dx, terms, ltransparm, dt);
+            const amrex::IntVect iv(AMREX_D_DECL(i, j, k));
+            return {(dt[ilim] <= dtlim) ? domain.index(iv) : nomatch};
+          });
+        amrex::ParallelDescriptor::ReduceLongMin(loc);
+        if (loc != nomatch) {
+          dt_limiter_cell = domain.atOffset(loc);
+        }
+      }
     }
   }
 
@@ -898,13 +992,25 @@ PeleC::estTimeStep(amrex::Real /*dt_old*/)
     if (estdt_particle < estdt) {
       limiter = "particles";
       estdt = estdt_particle;
+      dt_limiter_cell = amrex::IntVect(AMREX_D_DECL(-1, -1, -1));
     }
   }
 #endif
 
+  dt_limiter = limiter;
+
   if (verbose != 0) {
     amrex::Print() << "PeleC::estTimeStep (" << limiter << "-limited) at level "
                    << level << ":  estdt = " << estdt << '\n';
+    if (dt_limiter_cell[0] >= 0) {
+      amrex::Print() << "...limited by cell " << dt_limiter_cell << " at x = (";
+      for (int dir = 0; dir < AMREX_SPACEDIM; dir++) {
+        amrex::Print() << (dir > 0 ? ", " : "")
+                       << geom.ProbLo(dir) +
+                            (dt_limiter_cell[dir] + 0.5) * geom.CellSize(dir);
+      }
+      amrex::Print() << ")\n";
+    }
   }
 
   return estdt;
@@ -1066,6 +1172,44 @@ PeleC::post_timestep(int iteration)
 #endif
 
   problem_post_timestep();
+  pele::pelec::GradientCache::level(level).clear();
+
+  if (do_stats) {
+    update_stats(parent->dtLevel(level));
+  }
+
+  if (adaptive_regrid && level < parent->maxLevel()) {
+    track_front_travel(parent->dtLevel(level));
+  }
+
+  if (active_species) {
+    active_spec.update(
+      get_new_data(State_Type), geom, level, numGrow(),
+      active_species_threshold);
+    if (verbose > 0) {
+      amrex::Real mean = 0.0;
+      int nmin = 0;
+      int nmax = 0;
+      active_spec.stats(mean, nmin, nmax);
+      amrex::Print() << "... Active species on level " << level << ": " << mean
+                     << " per cell (" << nmin << " to " << nmax
+                     << " per box) of " << NUM_SPECIES
+                     << ", species flux work reduced "
+                     << NUM_SPECIES / amrex::max(mean, 1.0) << "x"
+                     << std::endl;
+    }
+  }
+
+  if (temp_newton && (verbose > 0)) {
+    amrex::Long counts[2] = {temp_newton_iters, temp_newton_cells};
+    amrex::ParallelDescriptor::ReduceLongSum(counts, 2);
+    const amrex::Real per_cell =
+      static_cast<amrex::Real>(counts[0]) /
+      static_cast<amrex::Real>(amrex::max(counts[1], amrex::Long(1)));
+    amrex::Print() << "... Temperature Newton iterations on level " << level
+                   << ": " << per_cell << " per cell (" << counts[1]
+                   << " cells)" << std::endl;
+  }
 
   if (level == 0) {
     int nstep = parent->levelSteps(0);
@@ -1091,6 +1235,9 @@ PeleC::post_timestep(int iteration)
       if (track_extrema) {
         monitor_extrema();
       }
+      if (track_entropy_budget) {
+        sum_entropy_budget();
+      }
     }
   }
 
@@ -1150,9 +1297,10 @@ PeleC::post_timestep(int iteration)
           amrlevel, R_data, R_data.nGrow(), cumtime, Reactions_Type, 0,
           NUM_SPECIES + 2, 0);
 
+        // With the EB factory of the level, for the volume fractions
         diagMFVec[lev] = std::make_unique<amrex::MultiFab>(
           amrlevel.boxArray(), amrlevel.DistributionMap(), m_diagVars.size(),
-          1);
+          1, amrex::MFInfo(), amrlevel.Factory());
         for (int v{0}; v < m_diagVars.size(); ++v) {
           // Already tested: either a derive or a state variable
           if (derive_lst.canDerive(m_diagVars[v])) {
@@ -1178,6 +1326,7 @@ PeleC::post_timestep(int iteration)
           }
         }
       }
+      pele::pelec::GradientCache::clearAll();
 
       for (int n = 0; n < m_diagnostics.size(); ++n) {
         if (m_diagnostics[n]->doDiag(cumtime, nstep)) {
@@ -1194,6 +1343,8 @@ PeleC::post_restart()
 {
   BL_PROFILE("PeleC::post_restart()");
 
+  pele::pelec::GradientCache::level(level).clear();
+
   // Copy problem parameter structs to device
   amrex::Gpu::copy(
     amrex::Gpu::hostToDevice, PeleC::h_prob_parm_device,
@@ -1229,6 +1380,29 @@ PeleC::postCoarseTimeStep(amrex::Real cumtime)
 {
   BL_PROFILE("PeleC::postCoarseTimeStep()");
   AmrLevel::postCoarseTimeStep(cumtime);
+
+  const int nstep = parent->levelSteps(0);
+
+  // Incremental checkpoints, except on the steps Amr writes a full one
+  // (amr.check_int or amr.check_per), which becomes the new reference
+  if ((chk_delta_int > 0) && (nstep % chk_delta_int == 0)) {
+    const int check_int = parent->checkInt();
+    bool full_due = (check_int > 0) && (nstep % check_int == 0);
+    const amrex::Real check_per = parent->checkPer();
+    if (check_per > 0.0) {
+      const amrex::Real dtlev = parent->dtLevel(0);
+      const int num_per_old =
+        static_cast<int>(std::floor((cumtime - dtlev) / check_per));
+      const int num_per_new = static_cast<int>(std::floor(cumtime / check_per));
+      full_due = full_due || (num_per_old != num_per_new);
+    }
+    if (!full_due) {
+      writeDeltaCheckpoint(nstep, cumtime);
+    }
+  }
+
+  pele::pelec::PerfCounters::report(
+    nstep, cumtime, perf_report_int > 0 && nstep % perf_report_int == 0);
 }
 
 void
@@ -1236,6 +1410,7 @@ PeleC::post_regrid(int lbase, int /*new_finest*/)
 {
   BL_PROFILE("PeleC::post_regrid()");
   fine_mask.clear();
+  pc_bcfill_clear_cache();
 
 #ifdef PELEC_USE_SPRAY
   if (lbase == level) {
@@ -1248,6 +1423,71 @@ PeleC::post_regrid(int lbase, int /*new_finest*/)
   if ((do_react) && (use_typical_vals_chem)) {
     set_typical_values_chem();
   }
+
+  // The grids finer than this level were rebuilt around the current fronts
+  if (level >= lbase) {
+    front_travel = 0.0;
+  }
+}
+
+bool
+PeleC::okToRegrid()
+{
+  if (!adaptive_regrid) {
+    return true;
+  }
+
+  // Regrid before the fronts can leave the error buffer of the tagged cells
+  const amrex::Real dxmin = amrex::min(AMREX_D_DECL(
+    geom.CellSize(0), geom.CellSize(1), geom.CellSize(2)));
+  const amrex::Real buffer =
+    adaptive_regrid_buffer_frac * parent->nErrorBuf(level) * dxmin;
+  const int steps = parent->levelCount(level);
+  const bool regrid =
+    (steps >= adaptive_regrid_max_int) || (front_travel >= buffer);
+  // Only count the regrids a fixed amr.regrid_int schedule would have done
+  const int regrid_int = amrex::max(parent->regridInt(level), 1);
+  if (!regrid && (steps % regrid_int == 0)) {
+    regrids_avoided++;
+  }
+
+  if (verbose > 0) {
+    amrex::Print() << "... Adaptive regrid above level " << level << ": fronts "
+                   << front_travel << " / " << buffer << " after " << steps
+                   << " steps, " << (regrid ? "regridding" : "skipped") << " ("
+                   << regrids_avoided << " regrids avoided)" << std::endl;
+  }
+
+  return regrid;
+}
+
+void
+PeleC::track_front_travel(amrex::Real dt)
+{
+  BL_PROFILE("PeleC::track_front_travel()");
+
+  const amrex::MultiFab& S_new = get_new_data(State_Type);
+  auto const& s_arrs = S_new.const_arrays();
+  auto const& vf_arrs = vfrac.const_arrays();
+  amrex::Real umax = amrex::ParReduce(
+    amrex::TypeList<amrex::ReduceOpMax>{}, amrex::TypeList<amrex::Real>{},
+    S_new, amrex::IntVect(0),
+    [=] AMREX_GPU_DEVICE(int nbx, int i, int j, int k) noexcept
+    -> amrex::GpuTuple<amrex::Real> {
+      if (vf_arrs[nbx](i, j, k) <= 0.0) {
+        return {0.0};
+      }
+      auto const& s = s_arrs[nbx];
+      amrex::Real u2 = 0.0;
+      for (int dir = 0; dir < AMREX_SPACEDIM; dir++) {
+        const amrex::Real u = s(i, j, k, UMX + dir) / s(i, j, k, URHO);
+        u2 += u * u;
+      }
+      return {std::sqrt(u2)};
+    });
+  amrex::ParallelDescriptor::ReduceRealMax(umax);
+
+  front_travel += (umax + adaptive_regrid_front_speed) * dt;
 }
 
 void
@@ -1319,6 +1559,9 @@ PeleC::post_init(amrex::Real /*stop_time*/)
     if (track_extrema) {
       monitor_extrema();
     }
+    if (track_entropy_budget) {
+      sum_entropy_budget();
+    }
   }
 }
 
@@ -1395,6 +1638,10 @@ PeleC::avgDown()
 
   avgDown(State_Type);
   avgDown(Reactions_Type);
+  pele::pelec::GradientCache::level(level).clear();
+  if (do_entropy_state) {
+    avgDown(Entropy_Type);
+  }
 }
 
 void
@@ -1470,14 +1717,47 @@ PeleC::errorEst(
 {
   BL_PROFILE("PeleC::errorEst()");
 
+  // Entropy production is only evaluated when requested at this level, and
+  // on a grown box (hence one more ghost cell) for its gradient criterion
+  const bool do_ent_err = tagging_parm->do_entropyerr_tag &&
+                          (level < tagging_parm->max_entropyerr_lev);
+  const int max_term_lev[ent_total] = {
+    tagging_parm->max_entropy_visc_err_lev,
+    tagging_parm->max_entropy_heat_err_lev,
+    tagging_parm->max_entropy_diff_err_lev,
+    tagging_parm->max_entropy_chem_err_lev};
+  bool do_ent_term[ent_total];
+  bool ent_err_tag = do_ent_err;
+  for (int t = 0; t < ent_total; t++) {
+    do_ent_term[t] =
+      tagging_parm->do_entropy_term_tag[t] && (level < max_term_lev[t]);
+    ent_err_tag = ent_err_tag || do_ent_term[t];
+  }
+  const bool ent_grad_tag = tagging_parm->do_entropygrad_tag &&
+                            (level < tagging_parm->max_entropygrad_lev);
+  const bool ent_tag =
+    tagging_parm->do_entropy_tag && (ent_err_tag || ent_grad_tag);
+  // With pelec.do_entropy_state the terms of the last advance are reused,
+  // once there has been one (they are computed from the state until then)
+  const bool ent_from_state =
+    ent_tag && do_entropy_state && entropy_state_valid;
+  const int nghost_tag = (ent_tag && ent_grad_tag && !ent_from_state) ? 2 : 1;
+
   amrex::MultiFab S_data(
     get_new_data(State_Type).boxArray(),
-    get_new_data(State_Type).DistributionMap(), NVAR, 1, amrex::MFInfo(),
-    Factory());
+    get_new_data(State_Type).DistributionMap(), NVAR, nghost_tag,
+    amrex::MFInfo(), Factory());
   const amrex::Real cur_time = state[State_Type].curTime();
   FillPatch(
     *this, S_data, S_data.nGrow(), cur_time, State_Type, Density, NVAR, 0);
 
+  amrex::MultiFab E_data;
+  if (ent_from_state) {
+    E_data.define(grids, dmap, ent_num_comps, 1, amrex::MFInfo(), Factory());
+    FillPatch(
+      *this, E_data, E_data.nGrow(), cur_time, Entropy_Type, 0, ent_num_comps);
+  }
+
   amrex::Vector<amrex::BCRec> bcs(NVAR);
   const char tagval = amrex::TagBox::SET;
 
@@ -1687,6 +1967,55 @@ PeleC::errorEst(
         }
       }
 
+      // Tagging entropy production
+      if (ent_tag) {
+        amrex::FArrayBox S_entData;
+        amrex::Array4<const amrex::Real> S_entarr;
+        if (ent_from_state) {
+          S_entarr = E_data.const_array(mfi);
+        } else {
+          const amrex::Box& entbox = ent_grad_tag ? datbox : tilebox;
+          S_entData.resize(datbox, ent_num_comps, amrex::The_Async_Arena());
+          S_entData.setVal<amrex::RunOn::Device>(0.0, datbox);
+          pc_derentropyprod(
+            entbox, S_entData, 0, ent_num_comps, S_data[mfi], geom, time, bc,
+            level);
+          S_entarr = S_entData.const_array();
+        }
+        const amrex::Array4<const amrex::Real> entprod(S_entarr, ent_total);
+
+        if (do_ent_err) {
+          const amrex::Real captured_entropyerr = tagging_parm->entropyerr;
+          amrex::ParallelFor(
+            tilebox, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
+              tag_error(i, j, k, tag_arr, entprod, captured_entropyerr, tagval);
+            });
+        }
+        if (ent_grad_tag) {
+          const amrex::Real captured_entropygrad = tagging_parm->entropygrad;
+          amrex::ParallelFor(
+            tilebox, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
+              tag_graderror(
+                i, j, k, tag_arr, entprod, captured_entropygrad, tagval);
+            });
+        }
+
+        // Per-term thresholds
+        const amrex::Real term_err[ent_total] = {
+          tagging_parm->entropy_visc_err, tagging_parm->entropy_heat_err,
+          tagging_parm->entropy_diff_err, tagging_parm->entropy_chem_err};
+        for (int t = 0; t < ent_total; t++) {
+          if (do_ent_term[t]) {
+            const amrex::Array4<const amrex::Real> term(S_entarr, t);
+            const amrex::Real captured_termerr = term_err[t];
+            amrex::ParallelFor(
+              tilebox, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
+                tag_error(i, j, k, tag_arr, term, captured_termerr, tagval);
+              });
+          }
+        }
+      }
+
       if (eb_in_domain) {
         // Tagging volume fraction
         if (level < tagging_parm->max_vfracerr_lev) {
@@ -1825,14 +2154,30 @@ PeleC::derive(const std::string& name, amrex::Real time, int ngrow)
     return mf;
   }
 
+  ngrow += derive_extra_grow(name);
+
+  return AmrLevel::derive(name, time, ngrow);
+}
+
+int
+PeleC::derive_extra_grow(const std::string& name)
+{
   // For those using GrowBoxByOne we need this
   if (
     (name == "enstrophy") || (name == "magvort") || (name == "divu") ||
     (name == "vel_ders")) {
-    ngrow += 1;
+    return 1;
   }
+  return 0;
+}
 
-  return AmrLevel::derive(name, time, ngrow);
+bool
+PeleC::derive_overridden(const std::string& name)
+{
+  if (name == "vfrac") {
+    return true;
+  }
+  return do_les && ((name == "C_s2") || (name == "C_I") || (name == "Pr_T"));
 }
 
 void
@@ -2036,13 +2381,54 @@ PeleC::computeTemp(amrex::MultiFab& S, int ng)
   auto const& sarrs = S.arrays();
   auto const& flagarrs = flags.const_arrays();
   const amrex::IntVect ngs(ng);
-  amrex::ParallelFor(
-    S, ngs, [=] AMREX_GPU_DEVICE(int nbx, int i, int j, int k) noexcept {
-      if (!flagarrs[nbx](i, j, k).isCovered()) {
-        pc_cmpTemp(i, j, k, sarrs[nbx]);
-      }
-    });
-  amrex::Gpu::synchronize();
+  if (
+    !temp_newton ||
+    !std::is_same<
+      pele::physics::PhysicsType::eos_type, pele::physics::eos::Fuego>::value) {
+    amrex::ParallelFor(
+      S, ngs, [=] AMREX_GPU_DEVICE(int nbx, int i, int j, int k) noexcept {
+        if (!flagarrs[nbx](i, j, k).isCovered()) {
+          pc_cmpTemp(i, j, k, sarrs[nbx]);
+        }
+      });
+    amrex::Gpu::synchronize();
+    return;
+  }
+
+  // Newton iterations from the previous temperature, one cell per thread on
+  // GPUs and in batches of consecutive cells on CPUs
+  BL_PROFILE("PeleC::computeTemp_newton()");
+  const amrex::Real tol = temp_newton_tol;
+  const int maxiter = temp_newton_max_iter;
+  amrex::Long iters = 0;
+  amrex::Long cells = 0;
+  if (amrex::Gpu::inLaunchRegion()) {
+    auto r = amrex::ParReduce(
+      amrex::TypeList<amrex::ReduceOpSum, amrex::ReduceOpSum>{},
+      amrex::TypeList<amrex::Long, amrex::Long>{}, S, ngs,
+      [=] AMREX_GPU_DEVICE(int nbx, int i, int j, int k) noexcept
+      -> amrex::GpuTuple<amrex::Long, amrex::Long> {
+        if (flagarrs[nbx](i, j, k).isCovered()) {
+          return {0, 0};
+        }
+        return {
+          pc_cmpTemp_newton(i, j, k, sarrs[nbx], tol, maxiter), 1};
+      });
+    iters = amrex::get<0>(r);
+    cells = amrex::get<1>(r);
+  } else {
+#ifdef AMREX_USE_OMP
+#pragma omp parallel reduction(+ : iters, cells)
+#endif
+    for (amrex::MFIter mfi(S, amrex::TilingIfNotGPU()); mfi.isValid();
+         ++mfi) {
+      pc_cmpTemp_newton_rows(
+        mfi.growntilebox(ng), S.array(mfi), flags.const_array(mfi), tol,
+        maxiter, iters, cells);
+    }
+  }
+  temp_newton_iters += iters;
+  temp_newton_cells += cells;
 }
 
 amrex::Real
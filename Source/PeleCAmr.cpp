@@ -1,4 +1,9 @@
+#include <AMReX_EBFArrayBox.H>
+
+#include "GradCache.H"
 #include "PeleCAmr.H"
+#include "PerfCounters.H"
+#include "PltCompress.H"
 
 #ifdef PELEC_USE_SPRAY
 #include "SprayParticles.H"
@@ -45,6 +50,14 @@ PeleCAmr::writePlotFile()
 #endif
 #endif
   
+  amrex::Long ncells = 0;
+  for (int lev = 0; lev <= finest_level; ++lev) {
+    ncells += boxArray(lev).numPts();
+  }
+  pele::pelec::PerfTimer perf_timer(
+    0, pele::pelec::perf_io, ncells,
+    ncells * static_cast<amrex::Long>(statePlotVars().size()) *
+      static_cast<amrex::Long>(sizeof(amrex::Real)));
   writePlotFileDoit(pltfile, true, write_hdf5_plots, hdf5_compression);
 }
 
@@ -81,12 +94,28 @@ PeleCAmr::writeSmallPlotFile()
   writePlotFileDoit(pltfile, false);
 }
 
+namespace {
+
+// Derived variable of a plotfile and its location in the plot MultiFab
+struct PlotDerive
+{
+  std::string name;
+  const amrex::DeriveRec* rec{nullptr};
+  int dcomp{0};
+  int type{0};
+  int scomp{0};
+};
+
+} // namespace
+
 void
 PeleCAmr::constructPlotMF(
   const bool regular,
   amrex::Vector<std::unique_ptr<amrex::MultiFab>>& plotMFs,
   amrex::Vector<std::string>& plt_var_names)
 {
+  BL_PROFILE("PeleCAmr::constructPlotMF()");
+
   const auto& desc_lst = amrex::AmrLevel::get_desc_lst();
   amrex::Vector<std::pair<int, int>> plot_var_map;
   for (int typ = 0; typ < desc_lst.size(); typ++) {
@@ -131,7 +160,46 @@ PeleCAmr::constructPlotMF(
   const amrex::Real cur_time =
     (amr_level[0]->get_state_data(State_Type)).curTime();
 
+  // The derives reading a single range of a state type are computed from
+  // one FillPatch per level and state type, covering the components and
+  // ghost cells of all of them, directly into the plot MultiFab. The others
+  // go through AmrLevel::derive.
+  amrex::Vector<PlotDerive> direct;
+  amrex::Vector<PlotDerive> indirect;
+  amrex::Vector<int> fill_lo(desc_lst.size(), -1);
+  amrex::Vector<int> fill_hi(desc_lst.size(), -1);
+  int fill_grow = 0;
+  int dcomp = static_cast<int>(plot_var_map.size());
+  for (const auto& derive_name : derive_names) {
+    const amrex::DeriveRec* rec = derive_lst.get(derive_name);
+    PlotDerive d{derive_name, rec, dcomp, 0, 0};
+    dcomp += rec->numDerive();
+    if (
+      (rec->derFuncFab() == nullptr) || (rec->numRange() != 1) ||
+      (rec->deriveType() != amrex::IndexType::TheCellType()) ||
+      PeleC::derive_overridden(derive_name)) {
+      indirect.push_back(d);
+      continue;
+    }
+    int ncomp = 0;
+    rec->getRange(0, d.type, d.scomp, ncomp);
+    fill_lo[d.type] =
+      fill_lo[d.type] < 0 ? d.scomp : amrex::min(fill_lo[d.type], d.scomp);
+    fill_hi[d.type] = amrex::max(fill_hi[d.type], d.scomp + ncomp);
+    const amrex::Box bx0(amrex::IntVect(0), amrex::IntVect(1));
+    fill_grow = amrex::max(
+      fill_grow, bx0.smallEnd(0) - rec->boxMap()(bx0).smallEnd(0) +
+                   PeleC::derive_extra_grow(derive_name));
+    direct.push_back(d);
+  }
+  for (auto& d : direct) {
+    d.scomp -= fill_lo[d.type];
+  }
+  const int derive_end = dcomp;
+
   const int nlevels = finestLevel() + 1;
+  amrex::Vector<amrex::Vector<std::unique_ptr<amrex::MultiFab>>> fills(
+    nlevels);
   for (int lev = 0; lev < nlevels; ++lev) {
 
     plotMFs[lev] = std::make_unique<amrex::MultiFab>(
@@ -147,18 +215,68 @@ PeleCAmr::constructPlotMF(
       amrex::MultiFab::Copy(*plotMFs[lev], this_dat, comp, cnt, 1, nGrow);
       cnt++;
     }
-    
-    // Cull data from derived variables.
-    if ((!derive_names.empty())) {
-      for (const auto& derive_name : derive_names) {
-        const amrex::DeriveRec* rec = derive_lst.get(derive_name);
-        int ncomp = rec->numDerive();
-        auto derive_dat = amr_level[lev]->derive(derive_name, cur_time, nGrow);
-        amrex::MultiFab::Copy(*plotMFs[lev], *derive_dat, 0, cnt, ncomp, nGrow);
-        cnt += ncomp;
+
+    // Sources of the direct derives
+    fills[lev].resize(desc_lst.size());
+    for (int typ = 0; typ < desc_lst.size(); typ++) {
+      if (fill_lo[typ] >= 0) {
+        const int ncomp = fill_hi[typ] - fill_lo[typ];
+        fills[lev][typ] = std::make_unique<amrex::MultiFab>(
+          boxArray(lev), DistributionMap(lev), ncomp, fill_grow,
+          amrex::MFInfo(), amr_level[lev]->Factory());
+        amrex::AmrLevel::FillPatch(
+          *amr_level[lev], *fills[lev][typ], fill_grow, cur_time, typ,
+          fill_lo[typ], ncomp, 0);
       }
     }
 
+    // Cull data from the other derived variables.
+    for (const auto& d : indirect) {
+      const int ncomp = d.rec->numDerive();
+      auto derive_dat = amr_level[lev]->derive(d.name, cur_time, nGrow);
+      amrex::MultiFab::Copy(
+        *plotMFs[lev], *derive_dat, 0, d.dcomp, ncomp, nGrow);
+    }
+  }
+
+  // A single parallel region for all the levels, whose tiles the threads
+  // share one level after the other
+  if (!direct.empty()) {
+#ifdef AMREX_USE_OMP
+#pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
+#endif
+    for (int lev = 0; lev < nlevels; ++lev) {
+      for (amrex::MFIter mfi(*plotMFs[lev], amrex::TilingIfNotGPU());
+           mfi.isValid(); ++mfi) {
+        const amrex::Box& bx = mfi.tilebox();
+        for (const auto& d : direct) {
+          const int ncomp = d.rec->numDerive();
+          amrex::FArrayBox derfab(
+            (*plotMFs[lev])[mfi], amrex::make_alias, d.dcomp, ncomp);
+          const auto derive = [&](const amrex::FArrayBox& datfab) {
+            d.rec->derFuncFab()(
+              bx, derfab, 0, ncomp, datfab, Geom(lev), cur_time,
+              d.rec->getBC(), lev);
+          };
+          // Keep the EB flags of the source for the derives reading them
+          // (amrex::getEBCellFlagFab)
+          const amrex::FArrayBox& src = (*fills[lev][d.type])[mfi];
+          const auto* ebsrc = dynamic_cast<const amrex::EBFArrayBox*>(&src);
+          if (ebsrc != nullptr) {
+            derive(amrex::EBFArrayBox(
+              *ebsrc, amrex::make_alias, d.scomp, d.rec->numState()));
+          } else {
+            derive(amrex::FArrayBox(
+              src, amrex::make_alias, d.scomp, d.rec->numState()));
+          }
+        }
+      }
+    }
+  }
+
+  for (int lev = 0; lev < nlevels; ++lev) {
+    int cnt = derive_end;
+
 #ifdef PELEC_USE_SPRAY
     if (SprayParticleContainer::NumDeriveVars() > 0 && regular) {
       const int num_spray_derive = SprayParticleContainer::NumDeriveVars();
@@ -217,6 +335,9 @@ PeleCAmr::constructPlotMF(
   }
 
   AMREX_ASSERT(n_data_items == plt_var_names.size());
+
+  // The gradients shared by the derives are not kept past the plotfile
+  pele::pelec::GradientCache::clearAll();
 }
 
 void
@@ -247,25 +368,42 @@ PeleCAmr::writePlotFileDoit(
     istep[lev] = levelSteps(lev);
   }
 
-#ifdef AMREX_USE_HDF5
-  if (write_hdf5_plots) {
-    amrex::WriteMultiLevelPlotfileHDF5SingleDset(
+  // Compressed plotfiles replace the native format, not HDF5
+  const bool compressed = PeleC::plot_compression && !write_hdf5_plots;
+  if (compressed) {
+    const auto tols = pele::pelec::plotCompressionTols(
+      plt_var_names, PeleC::plot_compression_rel_tol,
+      PeleC::plot_compression_abs_tol);
+    pele::pelec::writeCompressedPlotfile(
       pltfile, nlevels, plotMFs_constvec, plt_var_names, Geom(), cur_time,
-      istep, refRatio(), hdf5_compression);
+      istep, refRatio(), tols, verbose > 0);
   } else {
+#ifdef AMREX_USE_HDF5
+    if (write_hdf5_plots) {
+      amrex::WriteMultiLevelPlotfileHDF5SingleDset(
+        pltfile, nlevels, plotMFs_constvec, plt_var_names, Geom(), cur_time,
+        istep, refRatio(), hdf5_compression);
+    } else {
 #endif
-    (void)hdf5_compression; // Avoid unused warning
-    amrex::WriteMultiLevelPlotfile(
-      pltfile, nlevels, plotMFs_constvec, plt_var_names, Geom(), cur_time,
-      istep, refRatio());
+      (void)hdf5_compression; // Avoid unused warning
+      // In mixed precision the plot buffers are written in single precision
+      const amrex::FABio::Format fab_format = amrex::FArrayBox::getFormat();
+      if (PeleC::mixed_precision) {
+        amrex::FArrayBox::setFormat(amrex::FABio::FAB_NATIVE_32);
+      }
+      amrex::WriteMultiLevelPlotfile(
+        pltfile, nlevels, plotMFs_constvec, plt_var_names, Geom(), cur_time,
+        istep, refRatio());
+      amrex::FArrayBox::setFormat(fab_format);
 
-#ifdef AMREX_USE_HDF5   
-  }
+#ifdef AMREX_USE_HDF5
+    }
 #endif
+  }
 
   amrex::VisMF::IO_Buffer io_buffer(amrex::VisMF::GetIOBufferSize());
   std::ofstream HeaderFile;
-  if (!write_hdf5_plots) {
+  if (!write_hdf5_plots && !compressed) {
     HeaderFile.rdbuf()->pubsetbuf(io_buffer.dataPtr(), io_buffer.size());
     if (amrex::ParallelDescriptor::IOProcessor()) {
       // Only the IOProcessor() writes to the header file.
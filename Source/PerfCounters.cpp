@@ -0,0 +1,140 @@
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+#include <AMReX_ParallelDescriptor.H>
+#include <AMReX_Print.H>
+#include <AMReX_Gpu.H>
+
+#include "PerfCounters.H"
+
+namespace pele::pelec {
+
+std::string PerfCounters::s_logfile;
+bool PerfCounters::s_sync = false;
+amrex::Vector<std::array<PerfRecord, perf_num_kernels>>
+  PerfCounters::s_records;
+
+void
+PerfCounters::init(const std::string& logfile, bool sync)
+{
+  s_logfile = logfile;
+  s_sync = sync;
+  s_records.clear();
+}
+
+const char*
+PerfCounters::kernelName(int kernel)
+{
+  static const char* names[perf_num_kernels] = {
+    "hydro",     "diffusion", "reactions", "eb_redist",
+    "fillpatch", "io",        "spray",     "spray_merge"};
+  return names[kernel];
+}
+
+amrex::Real
+PerfCounters::wtime()
+{
+  if (s_sync) {
+    amrex::Gpu::streamSynchronize();
+  }
+  return amrex::ParallelDescriptor::second();
+}
+
+void
+PerfCounters::add(
+  int lev, int kernel, amrex::Real wall, amrex::Long cells, amrex::Long bytes)
+{
+#ifdef AMREX_USE_OMP
+#pragma omp critical(pelec_perf_counters)
+#endif
+  {
+    if (lev >= s_records.size()) {
+      s_records.resize(lev + 1);
+    }
+    auto& rec = s_records[lev][kernel];
+    rec.wall += wall;
+    rec.cells += cells;
+    rec.bytes += bytes;
+    rec.calls += 1;
+  }
+}
+
+void
+PerfCounters::report(int step, amrex::Real time, bool print)
+{
+  if (s_logfile.empty() && !print) {
+    s_records.clear();
+    return;
+  }
+
+  // All ranks must agree on the number of levels before reducing. Cells and
+  // bytes are recorded from the global BoxArrays, only the wall time needs a
+  // reduction (slowest rank).
+  int nlev = static_cast<int>(s_records.size());
+  amrex::ParallelDescriptor::ReduceIntMax(nlev);
+  s_records.resize(nlev);
+
+  amrex::Vector<amrex::Real> wall(nlev * perf_num_kernels);
+  for (int lev = 0; lev < nlev; ++lev) {
+    for (int k = 0; k < perf_num_kernels; ++k) {
+      wall[lev * perf_num_kernels + k] = s_records[lev][k].wall;
+    }
+  }
+  amrex::ParallelDescriptor::ReduceRealMax(
+    wall.data(), static_cast<int>(wall.size()),
+    amrex::ParallelDescriptor::IOProcessorNumber());
+
+  if (amrex::ParallelDescriptor::IOProcessor()) {
+    std::ostringstream line;
+    line << std::setprecision(8);
+    line << "{\"step\":" << step << ",\"time\":" << time << ",\"levels\":[";
+    for (int lev = 0; lev < nlev; ++lev) {
+      line << (lev > 0 ? "," : "") << "{\"level\":" << lev;
+      for (int k = 0; k < perf_num_kernels; ++k) {
+        const auto& rec = s_records[lev][k];
+        const amrex::Real w = wall[lev * perf_num_kernels + k];
+        const amrex::Real cps = w > 0.0 ? rec.cells / w : 0.0;
+        const amrex::Real bps = w > 0.0 ? rec.bytes / w : 0.0;
+        line << ",\"" << kernelName(k) << "\":{\"wall\":" << w
+             << ",\"calls\":" << rec.calls << ",\"cells\":" << rec.cells
+             << ",\"bytes\":" << rec.bytes << ",\"cells_per_s\":" << cps
+             << ",\"bytes_per_s\":" << bps << "}";
+      }
+      line << "}";
+    }
+    line << "]}";
+
+    if (!s_logfile.empty()) {
+      std::ofstream os(s_logfile, std::ios::out | std::ios::app);
+      os << line.str() << "\n";
+    }
+
+    if (print) {
+      amrex::Print() << "PeleC perf counters at step " << step << ":\n";
+      amrex::Print() << std::setw(8) << "level" << std::setw(12) << "kernel"
+                     << std::setw(14) << "wall [s]" << std::setw(14)
+                     << "cells" << std::setw(14) << "Mcells/s" << std::setw(14)
+                     << "GB/s" << "\n";
+      for (int lev = 0; lev < nlev; ++lev) {
+        for (int k = 0; k < perf_num_kernels; ++k) {
+          const auto& rec = s_records[lev][k];
+          const amrex::Real w = wall[lev * perf_num_kernels + k];
+          if (rec.calls == 0) {
+            continue;
+          }
+          amrex::Print() << std::setw(8) << lev << std::setw(12)
+                         << kernelName(k) << std::setw(14) << w
+                         << std::setw(14) << rec.cells << std::setw(14)
+                         << (w > 0.0 ? 1.0e-6 * rec.cells / w : 0.0)
+                         << std::setw(14)
+                         << (w > 0.0 ? 1.0e-9 * rec.bytes / w : 0.0) << "\n";
+        }
+      }
+    }
+  }
+
+  s_records.clear();
+}
+
+} // namespace pele::pelec
@@ -0,0 +1,640 @@
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+
+#include <AMReX_FillPatchUtil.H>
+#include <AMReX_Interpolater.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_PhysBCFunct.H>
+#include <AMReX_Utility.H>
+#include <AMReX_VisMF.H>
+
+#include "PltCompress.H"
+
+namespace pele::pelec {
+
+namespace {
+
+const std::string pcz_version = "PeleC-PCZ-1.0";
+const std::string pcz_header = "PCZ_Header";
+
+// Cells per block, in the FAB order (first index fastest)
+constexpr int pcz_block = 64;
+
+// Width marking a block stored as raw doubles
+constexpr std::uint8_t pcz_raw = 0xFF;
+
+// Largest number of quantization steps in a block, so that the quantized
+// values and their deltas stay exact in doubles and 64 bit integers
+constexpr double pcz_max_steps = 1.0e15;
+
+template <typename T>
+void
+put(std::vector<unsigned char>& out, const T& val)
+{
+  const auto pos = out.size();
+  out.resize(pos + sizeof(T));
+  std::memcpy(out.data() + pos, &val, sizeof(T));
+}
+
+template <typename T>
+T
+get(const unsigned char*& in)
+{
+  T val;
+  std::memcpy(&val, in, sizeof(T));
+  in += sizeof(T);
+  return val;
+}
+
+// Quantize, delta code and bit pack one block. Returns false, without
+// writing anything, if some value would not be within eb
+bool
+encode_block(
+  const amrex::Real* v, const int n, const double eb,
+  std::vector<unsigned char>& out)
+{
+  if (eb <= 0.0) {
+    return false;
+  }
+  double vmin = v[0];
+  double vmax = v[0];
+  for (int i = 0; i < n; i++) {
+    if (!std::isfinite(v[i])) {
+      return false;
+    }
+    vmin = amrex::min<double>(vmin, v[i]);
+    vmax = amrex::max<double>(vmax, v[i]);
+  }
+  const double step = 2.0 * eb;
+  if ((vmax - vmin) > pcz_max_steps * step) {
+    return false;
+  }
+
+  std::uint64_t z[pcz_block];
+  std::uint64_t zall = 0;
+  std::int64_t prev = 0;
+  for (int i = 0; i < n; i++) {
+    const auto q =
+      static_cast<std::int64_t>(std::llround((v[i] - vmin) / step));
+    if (std::abs(vmin + step * static_cast<double>(q) - v[i]) > eb) {
+      return false;
+    }
+    const std::int64_t d = q - prev;
+    prev = q;
+    z[i] = (static_cast<std::uint64_t>(d) << 1) ^
+           static_cast<std::uint64_t>(d >> 63);
+    zall |= z[i];
+  }
+  int width = 0;
+  while ((zall >> width) != 0) {
+    width++;
+  }
+
+  out.push_back(static_cast<unsigned char>(width));
+  put(out, vmin);
+  std::uint64_t acc = 0;
+  int nbits = 0;
+  for (int i = 0; i < n; i++) {
+    acc |= z[i] << nbits;
+    nbits += width;
+    while (nbits >= 8) {
+      out.push_back(static_cast<unsigned char>(acc & 0xFF));
+      acc >>= 8;
+      nbits -= 8;
+    }
+  }
+  if (nbits > 0) {
+    out.push_back(static_cast<unsigned char>(acc & 0xFF));
+  }
+  return true;
+}
+
+void
+decode_block(
+  const unsigned char*& in, const int n, const double step, amrex::Real* v)
+{
+  const int width = *in++;
+  if (width == pcz_raw) {
+    for (int i = 0; i < n; i++) {
+      v[i] = static_cast<amrex::Real>(get<double>(in));
+    }
+    return;
+  }
+  const double vmin = get<double>(in);
+  const std::uint64_t mask =
+    (width == 0) ? 0 : ((static_cast<std::uint64_t>(1) << width) - 1);
+  std::uint64_t acc = 0;
+  int nbits = 0;
+  std::int64_t q = 0;
+  for (int i = 0; i < n; i++) {
+    while (nbits < width) {
+      acc |= static_cast<std::uint64_t>(*in++) << nbits;
+      nbits += 8;
+    }
+    const std::uint64_t z = acc & mask;
+    acc >>= width;
+    nbits -= width;
+    q += static_cast<std::int64_t>(z >> 1) ^ -static_cast<std::int64_t>(z & 1);
+    v[i] = static_cast<amrex::Real>(vmin + step * static_cast<double>(q));
+  }
+}
+
+std::string
+level_dir(const std::string& pltfile, const int lev)
+{
+  return pltfile + "/Level_" + std::to_string(lev);
+}
+
+} // namespace
+
+void
+encodeCompressedStream(
+  const amrex::Real* v, const amrex::Long n, const double eb,
+  std::vector<unsigned char>& out)
+{
+  out.clear();
+  put(out, eb);
+  for (amrex::Long b = 0; b < n; b += pcz_block) {
+    const int nb = static_cast<int>(amrex::min<amrex::Long>(pcz_block, n - b));
+    if (!encode_block(v + b, nb, eb, out)) {
+      out.push_back(pcz_raw);
+      for (int i = 0; i < nb; i++) {
+        put(out, static_cast<double>(v[b + i]));
+      }
+    }
+  }
+}
+
+void
+decodeCompressedStream(
+  const unsigned char* in, const amrex::Long n, amrex::Real* v)
+{
+  const double step = 2.0 * get<double>(in);
+  for (amrex::Long b = 0; b < n; b += pcz_block) {
+    const int nb = static_cast<int>(amrex::min<amrex::Long>(pcz_block, n - b));
+    decode_block(in, nb, step, v + b);
+  }
+}
+
+amrex::Vector<PltCompressTol>
+plotCompressionTols(
+  const amrex::Vector<std::string>& varnames,
+  const amrex::Real rel_tol,
+  const amrex::Real abs_tol)
+{
+  PltCompressTol def;
+  if (abs_tol > 0.0) {
+    def.tol = abs_tol;
+    def.relative = false;
+  } else {
+    def.tol = rel_tol;
+  }
+  amrex::Vector<PltCompressTol> tols(varnames.size(), def);
+
+  amrex::ParmParse pp("pelec");
+  amrex::Vector<std::string> entries;
+  pp.queryarr("plot_compression_var_tols", entries);
+  for (const auto& entry : entries) {
+    const auto p2 = entry.rfind(':');
+    const auto p1 = ((p2 == std::string::npos) || (p2 == 0))
+                      ? std::string::npos
+                      : entry.rfind(':', p2 - 1);
+    const std::string kind = (p1 == std::string::npos)
+                               ? std::string{}
+                               : entry.substr(p1 + 1, p2 - p1 - 1);
+    std::istringstream is(
+      (p2 == std::string::npos) ? std::string{} : entry.substr(p2 + 1));
+    PltCompressTol tol;
+    tol.relative = kind == "rel";
+    is >> tol.tol;
+    if (((kind != "abs") && (kind != "rel")) || is.fail() || tol.tol <= 0.0) {
+      amrex::Abort(
+        "pelec.plot_compression_var_tols: expected <var>:abs:<tol> or "
+        "<var>:rel:<tol> with a positive tolerance, got " +
+        entry);
+    }
+    const std::string name = entry.substr(0, p1);
+    bool found = false;
+    for (int n = 0; n < varnames.size(); n++) {
+      if (varnames[n] == name) {
+        tols[n] = tol;
+        found = true;
+      }
+    }
+    if (!found) {
+      amrex::Print() << "Warning: " << name
+                     << " in pelec.plot_compression_var_tols is not plotted"
+                     << std::endl;
+    }
+  }
+  return tols;
+}
+
+void
+writeCompressedPlotfile(
+  const std::string& pltfile,
+  const int nlevels,
+  const amrex::Vector<const amrex::MultiFab*>& mfs,
+  const amrex::Vector<std::string>& varnames,
+  const amrex::Vector<amrex::Geometry>& geoms,
+  const amrex::Real time,
+  const amrex::Vector<int>& level_steps,
+  const amrex::Vector<amrex::IntVect>& ref_ratio,
+  const amrex::Vector<PltCompressTol>& tols,
+  const bool verbose)
+{
+  BL_PROFILE("pele::pelec::writeCompressedPlotfile()");
+
+  const int nvars = static_cast<int>(varnames.size());
+  const int myproc = amrex::ParallelDescriptor::MyProc();
+  const int IOProc = amrex::ParallelDescriptor::IOProcessorNumber();
+
+  // Absolute error bound of each variable
+  amrex::Vector<double> ebs(nvars);
+  for (int n = 0; n < nvars; n++) {
+    if (!tols[n].relative) {
+      ebs[n] = tols[n].tol;
+      continue;
+    }
+    amrex::Real vmin = std::numeric_limits<amrex::Real>::max();
+    amrex::Real vmax = std::numeric_limits<amrex::Real>::lowest();
+    for (int lev = 0; lev < nlevels; lev++) {
+      vmin = amrex::min(vmin, mfs[lev]->min(n));
+      vmax = amrex::max(vmax, mfs[lev]->max(n));
+    }
+    const amrex::Real range = vmax - vmin;
+    ebs[n] = tols[n].tol * ((range > 0.0) ? range
+                                          : amrex::max<amrex::Real>(
+                                              std::abs(vmax), 1.0));
+  }
+
+  amrex::PreBuildDirectorHierarchy(pltfile, "Level_", nlevels, true);
+
+  amrex::Vector<amrex::Long> raw_bytes(nvars, 0);
+  amrex::Vector<amrex::Long> comp_bytes(nvars, 0);
+  amrex::Vector<amrex::Real> enc_time(nvars, 0.0);
+  amrex::Vector<amrex::Vector<amrex::Long>> box_loc(nlevels);
+
+  for (int lev = 0; lev < nlevels; lev++) {
+    AMREX_ALWAYS_ASSERT(mfs[lev]->nGrow() == 0);
+
+    // Compress from host memory
+#ifdef AMREX_USE_GPU
+    amrex::MultiFab host_mf(
+      mfs[lev]->boxArray(), mfs[lev]->DistributionMap(), nvars, 0,
+      amrex::MFInfo().SetArena(amrex::The_Pinned_Arena()));
+    amrex::dtoh_memcpy(host_mf, *mfs[lev]);
+    const amrex::MultiFab& src = host_mf;
+#else
+    const amrex::MultiFab& src = *mfs[lev];
+#endif
+
+    std::vector<std::vector<std::vector<unsigned char>>> bufs(
+      src.local_size(), std::vector<std::vector<unsigned char>>(nvars));
+    for (int n = 0; n < nvars; n++) {
+      const auto t0 = amrex::second();
+#ifdef AMREX_USE_OMP
+#pragma omp parallel
+#endif
+      for (amrex::MFIter mfi(src); mfi.isValid(); ++mfi) {
+        const auto& fab = src[mfi];
+        encodeCompressedStream(
+          fab.dataPtr(n), fab.box().numPts(), ebs[n],
+          bufs[mfi.LocalIndex()][n]);
+      }
+      enc_time[n] += amrex::second() - t0;
+      for (amrex::MFIter mfi(src); mfi.isValid(); ++mfi) {
+        raw_bytes[n] += src[mfi].box().numPts() *
+                        static_cast<amrex::Long>(sizeof(amrex::Real));
+        comp_bytes[n] +=
+          static_cast<amrex::Long>(bufs[mfi.LocalIndex()][n].size());
+      }
+    }
+
+    // Each box is located by its rank, offset and the size of each variable
+    const int nboxes = static_cast<int>(src.size());
+    const int stride = nvars + 2;
+    auto& idx = box_loc[lev];
+    idx.resize(static_cast<std::size_t>(nboxes) * stride, 0);
+    if (src.local_size() > 0) {
+      amrex::VisMF::IO_Buffer io_buffer(amrex::VisMF::GetIOBufferSize());
+      std::ofstream ofs;
+      ofs.rdbuf()->pubsetbuf(io_buffer.dataPtr(), io_buffer.size());
+      const std::string fname = level_dir(pltfile, lev) + "/" +
+                                amrex::Concatenate("Cell_D_", myproc, 5);
+      ofs.open(fname.c_str(), std::ios::out | std::ios::binary);
+      if (!ofs.good()) {
+        amrex::FileOpenFailed(fname);
+      }
+      amrex::Long offset = 0;
+      for (amrex::MFIter mfi(src); mfi.isValid(); ++mfi) {
+        auto* rec =
+          idx.data() + static_cast<std::size_t>(mfi.index()) * stride;
+        rec[0] = myproc;
+        rec[1] = offset;
+        for (int n = 0; n < nvars; n++) {
+          const auto& buf = bufs[mfi.LocalIndex()][n];
+          ofs.write(
+            reinterpret_cast<const char*>(buf.data()),
+            static_cast<std::streamsize>(buf.size()));
+          rec[2 + n] = static_cast<amrex::Long>(buf.size());
+          offset += rec[2 + n];
+        }
+      }
+      ofs.close();
+    }
+    amrex::ParallelDescriptor::ReduceLongSum(
+      idx.data(), static_cast<int>(idx.size()), IOProc);
+  }
+
+  if (amrex::ParallelDescriptor::IOProcessor()) {
+    std::ofstream hdr((pltfile + "/" + pcz_header).c_str());
+    if (!hdr.good()) {
+      amrex::FileOpenFailed(pltfile + "/" + pcz_header);
+    }
+    hdr << std::setprecision(17);
+    hdr << pcz_version << '\n' << nvars << '\n';
+    for (int n = 0; n < nvars; n++) {
+      hdr << varnames[n] << ' ' << ebs[n] << '\n';
+    }
+    hdr << AMREX_SPACEDIM << '\n' << time << '\n' << nlevels - 1 << '\n';
+    for (int d = 0; d < AMREX_SPACEDIM; d++) {
+      hdr << geoms[0].ProbLo(d) << ' ';
+    }
+    hdr << '\n';
+    for (int d = 0; d < AMREX_SPACEDIM; d++) {
+      hdr << geoms[0].ProbHi(d) << ' ';
+    }
+    hdr << '\n' << geoms[0].Coord() << '\n';
+    for (int d = 0; d < AMREX_SPACEDIM; d++) {
+      hdr << static_cast<int>(geoms[0].isPeriodic(d)) << ' ';
+    }
+    hdr << '\n';
+    for (int lev = 0; lev < nlevels - 1; lev++) {
+      hdr << ref_ratio[lev] << ' ';
+    }
+    hdr << '\n';
+    for (int lev = 0; lev < nlevels; lev++) {
+      hdr << level_steps[lev] << ' ';
+    }
+    hdr << '\n';
+    for (int lev = 0; lev < nlevels; lev++) {
+      const auto& ba = mfs[lev]->boxArray();
+      hdr << geoms[lev].Domain() << '\n' << ba.size() << '\n';
+      for (int i = 0; i < ba.size(); i++) {
+        hdr << ba[i];
+        const auto* rec =
+          box_loc[lev].data() + static_cast<std::size_t>(i) * (nvars + 2);
+        for (int c = 0; c < nvars + 2; c++) {
+          hdr << ' ' << rec[c];
+        }
+        hdr << '\n';
+      }
+    }
+  }
+
+  if (verbose) {
+    amrex::ParallelDescriptor::ReduceLongSum(raw_bytes.data(), nvars, IOProc);
+    amrex::ParallelDescriptor::ReduceLongSum(comp_bytes.data(), nvars, IOProc);
+    amrex::ParallelDescriptor::ReduceRealMax(enc_time.data(), nvars, IOProc);
+    amrex::Long raw_tot = 0;
+    amrex::Long comp_tot = 0;
+    amrex::Real time_tot = 0.0;
+    amrex::Print() << "Compressed plotfile " << pltfile << ":\n"
+                   << std::setw(24) << std::left << "  variable" << std::right
+                   << std::setw(14) << "bound" << std::setw(10) << "ratio"
+                   << std::setw(12) << "MB/s" << '\n';
+    for (int n = 0; n < nvars; n++) {
+      raw_tot += raw_bytes[n];
+      comp_tot += comp_bytes[n];
+      time_tot += enc_time[n];
+      amrex::Print() << "  " << std::setw(22) << std::left << varnames[n]
+                     << std::right << std::setw(14) << std::setprecision(4)
+                     << ebs[n] << std::setw(10) << std::fixed
+                     << std::setprecision(2)
+                     << static_cast<amrex::Real>(raw_bytes[n]) /
+                          amrex::max<amrex::Long>(comp_bytes[n], 1)
+                     << std::setw(12) << std::setprecision(1)
+                     << 1.0e-6 * static_cast<amrex::Real>(raw_bytes[n]) /
+                          amrex::max<amrex::Real>(enc_time[n], 1.0e-12)
+                     << std::defaultfloat << '\n';
+    }
+    amrex::Print() << "  total: " << raw_tot << " -> " << comp_tot
+                   << " bytes, ratio "
+                   << static_cast<amrex::Real>(raw_tot) /
+                        amrex::max<amrex::Long>(comp_tot, 1)
+                   << ", "
+                   << 1.0e-6 * static_cast<amrex::Real>(raw_tot) /
+                        amrex::max<amrex::Real>(time_tot, 1.0e-12)
+                   << " MB/s" << std::endl;
+  }
+}
+
+bool
+CompressedPltFile::isCompressed(const std::string& pltfile)
+{
+  return amrex::FileExists(pltfile + "/" + pcz_header);
+}
+
+CompressedPltFile::CompressedPltFile(const std::string& pltfile)
+{
+  BL_PROFILE("pele::pelec::CompressedPltFile()");
+
+  amrex::Vector<char> file_chars;
+  amrex::ParallelDescriptor::ReadAndBcastFile(
+    pltfile + "/" + pcz_header, file_chars);
+  std::istringstream is(std::string(file_chars.dataPtr()));
+
+  std::string version;
+  is >> version;
+  if (version != pcz_version) {
+    amrex::Abort(
+      "CompressedPltFile: unknown format " + version + " in " + pltfile);
+  }
+  int nvars = 0;
+  is >> nvars;
+  m_varnames.resize(nvars);
+  for (int n = 0; n < nvars; n++) {
+    double eb;
+    is >> m_varnames[n] >> eb;
+  }
+  int spacedim = 0;
+  amrex::Real time = 0.0;
+  int finest_level = 0;
+  is >> spacedim >> time >> finest_level;
+  if (spacedim != AMREX_SPACEDIM) {
+    amrex::Abort("CompressedPltFile: " + pltfile + " has a different dim");
+  }
+  const int nlevels = finest_level + 1;
+  amrex::Real prob_lo[AMREX_SPACEDIM];
+  amrex::Real prob_hi[AMREX_SPACEDIM];
+  for (auto& lo : prob_lo) {
+    is >> lo;
+  }
+  for (auto& hi : prob_hi) {
+    is >> hi;
+  }
+  int coord = 0;
+  amrex::Array<int, AMREX_SPACEDIM> is_per{AMREX_D_DECL(0, 0, 0)};
+  is >> coord;
+  for (auto& per : is_per) {
+    is >> per;
+  }
+  m_ref_ratio.resize(finest_level);
+  for (auto& rr : m_ref_ratio) {
+    is >> rr;
+  }
+  amrex::Vector<int> level_steps(nlevels);
+  for (auto& step : level_steps) {
+    is >> step;
+  }
+
+  const amrex::RealBox rb(prob_lo, prob_hi);
+  amrex::Long raw_bytes = 0;
+  amrex::Long comp_bytes = 0;
+  amrex::Real dec_time = 0.0;
+  for (int lev = 0; lev < nlevels; lev++) {
+    amrex::Box domain;
+    int nboxes = 0;
+    is >> domain >> nboxes;
+    m_geoms.emplace_back(domain, rb, coord, is_per);
+
+    amrex::BoxList bl;
+    amrex::Vector<amrex::Vector<amrex::Long>> loc(nboxes);
+    for (int i = 0; i < nboxes; i++) {
+      amrex::Box bx;
+      is >> bx;
+      bl.push_back(bx);
+      loc[i].resize(nvars + 2);
+      for (auto& l : loc[i]) {
+        is >> l;
+      }
+    }
+    if (is.fail()) {
+      amrex::Abort(
+        "CompressedPltFile: unable to parse the header of " + pltfile);
+    }
+    const amrex::BoxArray ba(std::move(bl));
+    const amrex::DistributionMapping dm(ba);
+    m_data.emplace_back(ba, dm, nvars, 0);
+
+#ifdef AMREX_USE_GPU
+    amrex::MultiFab host_mf(
+      ba, dm, nvars, 0, amrex::MFInfo().SetArena(amrex::The_Pinned_Arena()));
+    amrex::MultiFab& dst = host_mf;
+#else
+    amrex::MultiFab& dst = m_data[lev];
+#endif
+
+    const auto t0 = amrex::second();
+    std::ifstream ifs;
+    int open_rank = -1;
+    std::vector<unsigned char> buf;
+    for (amrex::MFIter mfi(dst); mfi.isValid(); ++mfi) {
+      const auto& rec = loc[mfi.index()];
+      if (rec[0] != open_rank) {
+        ifs.close();
+        open_rank = static_cast<int>(rec[0]);
+        const std::string fname =
+          level_dir(pltfile, lev) + "/" +
+          amrex::Concatenate("Cell_D_", open_rank, 5);
+        ifs.open(fname.c_str(), std::ios::in | std::ios::binary);
+        if (!ifs.good()) {
+          amrex::FileOpenFailed(fname);
+        }
+      }
+      amrex::Long nbytes = 0;
+      for (int n = 0; n < nvars; n++) {
+        nbytes += rec[2 + n];
+      }
+      buf.resize(nbytes);
+      ifs.seekg(rec[1], std::ios::beg);
+      ifs.read(reinterpret_cast<char*>(buf.data()), nbytes);
+      if (!ifs.good()) {
+        amrex::Abort("CompressedPltFile: truncated data in " + pltfile);
+      }
+      auto& fab = dst[mfi];
+      const amrex::Long npts = fab.box().numPts();
+      const unsigned char* in = buf.data();
+      for (int n = 0; n < nvars; n++) {
+        decodeCompressedStream(in, npts, fab.dataPtr(n));
+        in += rec[2 + n];
+      }
+      raw_bytes += npts * nvars * static_cast<amrex::Long>(sizeof(amrex::Real));
+      comp_bytes += nbytes;
+    }
+    dec_time += amrex::second() - t0;
+
+#ifdef AMREX_USE_GPU
+    amrex::htod_memcpy(m_data[lev], host_mf);
+#endif
+  }
+
+  const int IOProc = amrex::ParallelDescriptor::IOProcessorNumber();
+  amrex::ParallelDescriptor::ReduceLongSum(raw_bytes, IOProc);
+  amrex::ParallelDescriptor::ReduceLongSum(comp_bytes, IOProc);
+  amrex::ParallelDescriptor::ReduceRealMax(dec_time, IOProc);
+  amrex::Print() << "Read compressed plotfile " << pltfile << " (step "
+                 << level_steps[0] << ", time " << time << "): " << comp_bytes
+                 << " -> " << raw_bytes << " bytes at "
+                 << 1.0e-6 * static_cast<amrex::Real>(raw_bytes) /
+                      amrex::max<amrex::Real>(dec_time, 1.0e-12)
+                 << " MB/s" << std::endl;
+}
+
+void
+CompressedPltFile::fillPatchFromPlt(
+  const int lev,
+  const amrex::Geometry& geom,
+  const int pltComp,
+  const int dataComp,
+  const int nComp,
+  amrex::MultiFab& mf)
+{
+  BL_PROFILE("pele::pelec::CompressedPltFile::fillPatchFromPlt()");
+
+  amrex::Vector<amrex::BCRec> bcs(nComp);
+  for (auto& bc : bcs) {
+    for (int d = 0; d < AMREX_SPACEDIM; d++) {
+      const int type =
+        geom.isPeriodic(d) ? amrex::BCType::int_dir : amrex::BCType::foextrap;
+      bc.setLo(d, type);
+      bc.setHi(d, type);
+    }
+  }
+  amrex::PhysBCFunctNoOp bc_noop;
+  amrex::Interpolater* mapper = &amrex::cell_cons_interp;
+  const int nplt = static_cast<int>(m_data.size());
+
+  if ((lev < nplt) && (geom.Domain() != m_geoms[lev].Domain())) {
+    amrex::Abort(
+      "CompressedPltFile: level " + std::to_string(lev) +
+      " does not match the domain of the plotfile");
+  }
+
+  if (lev == 0) {
+    amrex::FillPatchSingleLevel(
+      mf, amrex::IntVect(0), 0.0, {&m_data[0]}, {0.0}, pltComp, dataComp,
+      nComp, geom, bc_noop, 0);
+  } else if (lev < nplt) {
+    amrex::FillPatchTwoLevels(
+      mf, amrex::IntVect(0), 0.0, {&m_data[lev - 1]}, {0.0}, {&m_data[lev]},
+      {0.0}, pltComp, dataComp, nComp, m_geoms[lev - 1], m_geoms[lev], bc_noop,
+      0, bc_noop, 0, m_ref_ratio[lev - 1], mapper, bcs, 0);
+  } else {
+    // Finer than the plotfile: interpolate from its finest level
+    const auto& cgeom = m_geoms[nplt - 1];
+    const amrex::IntVect ratio =
+      geom.Domain().length() / cgeom.Domain().length();
+    amrex::InterpFromCoarseLevel(
+      mf, amrex::IntVect(0), 0.0, m_data[nplt - 1], pltComp, dataComp, nComp,
+      cgeom, geom, bc_noop, 0, bc_noop, 0, ratio, mapper, bcs, 0);
+  }
+}
+
+} // namespace pele::pelec
@@ -0,0 +1,167 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include <AMReX.H>
+#include <AMReX_GpuContainers.H>
+
+#include "ProfileTable.H"
+
+namespace pele::pelec {
+
+namespace {
+
+// Reference interpolation: linear search for the last interval containing
+// xq, as done by the original PMF problem setups
+amrex::Real
+search_value(
+  const amrex::Vector<amrex::Real>& x,
+  const amrex::Vector<amrex::Real>& y,
+  const int j,
+  const amrex::Real xq)
+{
+  const int n = static_cast<int>(x.size());
+  int lo = -1;
+  int hi = -1;
+  if (xq < x[0]) {
+    lo = 0;
+    hi = 0;
+  }
+  if (xq > x[n - 1]) {
+    lo = n - 1;
+    hi = n - 1;
+  }
+  if (lo == -1) {
+    for (int i = 0; i < n - 1; i++) {
+      if ((xq >= x[i]) && (xq <= x[i + 1])) {
+        lo = i;
+        hi = i + 1;
+      }
+    }
+  }
+  const amrex::Real y1 = y[j * n + lo];
+  const amrex::Real y2 = y[j * n + hi];
+  const amrex::Real dydx = (lo == hi) ? 0.0 : (y2 - y1) / (x[hi] - x[lo]);
+  return y1 + dydx * (xq - x[lo]);
+}
+
+} // namespace
+
+void
+ProfileTable::define(
+  const amrex::Vector<amrex::Real>& x,
+  const amrex::Vector<amrex::Real>& y,
+  int m)
+{
+  const int n = static_cast<int>(x.size());
+  if (n < 2 || y.size() < static_cast<amrex::Long>(n) * m) {
+    amrex::Abort("ProfileTable: need at least 2 points and n * m values");
+  }
+  if (!std::is_sorted(x.begin(), x.end())) {
+    amrex::Abort("ProfileTable: non ascending profile coordinates");
+  }
+
+  h_x = x;
+  h_y.assign(y.begin(), y.begin() + static_cast<amrex::Long>(n) * m);
+  h_slope.assign(h_y.size(), 0.0);
+  amrex::Real dxmin = x[n - 1] - x[0];
+  for (int i = 0; i < n - 1; i++) {
+    const amrex::Real dxi = x[i + 1] - x[i];
+    if (dxi > 0.0) {
+      dxmin = amrex::min(dxmin, dxi);
+      for (int j = 0; j < m; j++) {
+        h_slope[j * n + i] = (h_y[j * n + i + 1] - h_y[j * n + i]) / dxi;
+      }
+    }
+  }
+
+  // Buckets about as fine as the finest profile spacing, capped so that
+  // strongly stretched profiles do not blow up the index
+  const amrex::Real span = x[n - 1] - x[0];
+  int nbucket = 1;
+  if (span > 0.0) {
+    const amrex::Real nfine = std::ceil(span / dxmin);
+    nbucket = static_cast<int>(
+      amrex::min<amrex::Real>(nfine, 16.0 * (n - 1)));
+    nbucket = amrex::max(nbucket, n - 1);
+  }
+  const amrex::Real bucket_dx = span / nbucket;
+  h_bucket.resize(nbucket);
+  m_max_steps = 0;
+  for (int b = 0; b < nbucket; b++) {
+    const amrex::Real edge = x[0] + b * bucket_dx;
+    const auto it = std::upper_bound(x.begin(), x.end(), edge);
+    h_bucket[b] = amrex::min(static_cast<int>(it - x.begin()) - 1, n - 2);
+    const amrex::Real next = x[0] + (b + 1) * bucket_dx;
+    const auto itn = std::upper_bound(x.begin(), x.end(), next);
+    m_max_steps = amrex::max(m_max_steps, static_cast<int>(itn - it));
+  }
+
+  d_x.resize(h_x.size());
+  d_y.resize(h_y.size());
+  d_slope.resize(h_slope.size());
+  d_bucket.resize(h_bucket.size());
+  amrex::Gpu::copy(
+    amrex::Gpu::hostToDevice, h_x.begin(), h_x.end(), d_x.begin());
+  amrex::Gpu::copy(
+    amrex::Gpu::hostToDevice, h_y.begin(), h_y.end(), d_y.begin());
+  amrex::Gpu::copy(
+    amrex::Gpu::hostToDevice, h_slope.begin(), h_slope.end(),
+    d_slope.begin());
+  amrex::Gpu::copy(
+    amrex::Gpu::hostToDevice, h_bucket.begin(), h_bucket.end(),
+    d_bucket.begin());
+
+  m_host.n = n;
+  m_host.m = m;
+  m_host.nbucket = nbucket;
+  m_host.bucket_dxinv = (span > 0.0) ? nbucket / span : 0.0;
+  m_device = m_host;
+  m_host.x = h_x.data();
+  m_host.y = h_y.data();
+  m_host.slope = h_slope.data();
+  m_host.bucket = h_bucket.data();
+  m_device.x = d_x.data();
+  m_device.y = d_y.data();
+  m_device.slope = d_slope.data();
+  m_device.bucket = d_bucket.data();
+}
+
+amrex::Real
+ProfileTable::check(int nsub) const
+{
+  const int n = m_host.n;
+  const int m = m_host.m;
+  if (n == 0) {
+    return 0.0;
+  }
+
+  amrex::Vector<amrex::Real> samples;
+  const amrex::Real span = h_x[n - 1] - h_x[0];
+  samples.push_back(h_x[0] - 0.1 * span);
+  samples.push_back(h_x[n - 1] + 0.1 * span);
+  for (int i = 0; i < n - 1; i++) {
+    for (int s = 0; s < nsub; s++) {
+      samples.push_back(h_x[i] + (h_x[i + 1] - h_x[i]) * s / nsub);
+    }
+  }
+  samples.push_back(h_x[n - 1]);
+
+  amrex::Real err = 0.0;
+  for (int j = 0; j < m; j++) {
+    const auto mm = std::minmax_element(
+      h_y.begin() + static_cast<amrex::Long>(j) * n,
+      h_y.begin() + static_cast<amrex::Long>(j + 1) * n);
+    const amrex::Real range = amrex::max<amrex::Real>(
+      *mm.second - *mm.first, std::abs(*mm.second),
+      std::numeric_limits<amrex::Real>::min());
+    for (const auto xq : samples) {
+      const amrex::Real ref = search_value(h_x, h_y, j, xq);
+      const amrex::Real val = m_host.value(m_host.interval(xq), j, xq);
+      err = amrex::max(err, std::abs(val - ref) / range);
+    }
+  }
+  return err;
+}
+
+} // namespace pele::pelec
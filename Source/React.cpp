@@ -3,6 +3,7 @@
 #include "IndexDefines.H"
 #include "PelePhysics.H"
 #include "PeleC.H"
+#include "PerfCounters.H"
 
 void
 PeleC::set_typical_values_chem()
@@ -35,6 +36,11 @@ PeleC::react_state(
 {
   // Update I_R, and recompute S_new
   BL_PROFILE("PeleC::react_state()");
+  const amrex::Long ncells = grids.numPts();
+  pele::pelec::PerfTimer perf_timer(
+    level, pele::pelec::perf_reactions, ncells,
+    ncells * (2 * NVAR + 2 * (NUM_SPECIES + 2)) *
+      static_cast<amrex::Long>(sizeof(amrex::Real)));
 
   const amrex::Real strt_time = amrex::ParallelDescriptor::second();
 
@@ -72,10 +78,8 @@ PeleC::react_state(
       non_react_src = &non_react_src_tmp;
 
       for (int n = 0; n < src_list.size(); ++n) {
-        amrex::MultiFab::Saxpy(
-          non_react_src_tmp, 0.5, *new_sources[src_list[n]], 0, 0, NVAR, ng);
-        amrex::MultiFab::Saxpy(
-          non_react_src_tmp, 0.5, *old_sources[src_list[n]], 0, 0, NVAR, ng);
+        new_sources[src_list[n]]->saxpy(non_react_src_tmp, 0.5, ng);
+        old_sources[src_list[n]]->saxpy(non_react_src_tmp, 0.5, ng);
       }
 
       if (do_hydro && !do_mol) {
@@ -11,7 +11,11 @@ using namespace MASA;
 #include "mechanism.H"
 #include "PeleC.H"
 #include "Derive.H"
+#include "DeltaCheckpoint.H"
+#include "EntropyProd.H"
 #include "IndexDefines.H"
+#include "PerfCounters.H"
+#include "ThermoTable.H"
 #include "prob.H"
 
 #ifdef PELEC_USE_SOOT
@@ -22,6 +26,10 @@ ProbParmDevice* PeleC::d_prob_parm_device = nullptr;
 ProbParmDevice* PeleC::h_prob_parm_device = nullptr;
 ProbParmHost* PeleC::prob_parm_host = nullptr;
 TaggingParm* PeleC::tagging_parm = nullptr;
+amrex::Vector<amrex::Real> PeleC::h_reac_nu;
+amrex::Vector<int> PeleC::reac_rmap;
+amrex::Real* PeleC::d_reac_nu = nullptr;
+int* PeleC::d_reac_rmap = nullptr;
 #ifdef PELEC_USE_SOOT
 SootModel PeleC::soot_model;
 #endif
@@ -150,11 +158,19 @@ PeleC::variableSetUp()
   if (trans_parms.host_trans_parm().use_soret) {
     amrex::Abort("PeleC does not support Soret effects yet.");
   }
+  init_reaction_stoich();
   turb_inflow.init(amrex::DefaultGeometry());
 
   // Get options, set phys_bc
   eb_in_domain = ebInDomain();
   read_params();
+  read_stats_params();
+  pele::pelec::PerfCounters::init(perf_log, perf_sync);
+  if (thermo_table) {
+    pele::pelec::ThermoTable::build(
+      thermo_table_Tmin, thermo_table_Tmax, thermo_table_dT, thermo_table_tol,
+      verbose > 0);
+  }
 
 #ifdef PELEC_USE_MASA
   if (do_mms) {
@@ -389,6 +405,32 @@ PeleC::variableSetUp()
     Work_Estimate_Type, 0, "WorkEstimate", bc,
     amrex::StateDescriptor::BndryFunc(pc_nullfill));
 
+  // Running statistics. Piecewise constant interpolation on regrid keeps the
+  // moments realizable (non-negative variances, bounded covariances).
+  const amrex::Vector<std::string> stats_name =
+    do_stats ? stats_names() : amrex::Vector<std::string>{"stats_time"};
+  const int nstats = static_cast<int>(stats_name.size());
+  desc_lst.addDescriptor(
+    Stats_Type, amrex::IndexType::TheCellType(), amrex::StateDescriptor::Point,
+    0, nstats, &amrex::pc_interp, state_data_extrap, do_stats);
+  set_react_src_bc(bc, phys_bc);
+  amrex::Vector<amrex::BCRec> stats_bcs(nstats, bc);
+  desc_lst.setComponent(Stats_Type, 0, stats_name, stats_bcs, bndryfunc2);
+
+  // Entropy production of the fluxes and sources used in the advance,
+  // recomputed every step so never checkpointed
+  if (do_entropy_state) {
+    const amrex::Vector<std::string> ent_name{
+      "ei_visc", "ei_heat", "ei_diff", "ei_chem", "ei_total"};
+    const int nent = static_cast<int>(ent_name.size());
+    desc_lst.addDescriptor(
+      Entropy_Type, amrex::IndexType::TheCellType(),
+      amrex::StateDescriptor::Point, 0, nent, &amrex::pc_interp,
+      state_data_extrap, false);
+    amrex::Vector<amrex::BCRec> ent_bcs(nent, bc);
+    desc_lst.setComponent(Entropy_Type, 0, ent_name, ent_bcs, bndryfunc2);
+  }
+
   num_state_type = desc_lst.size();
 
   // Get the level at which EB is generated
@@ -444,6 +486,21 @@ PeleC::variableSetUp()
     amrex::DeriveRec::GrowBoxByOne);
   derive_lst.addComponent("divu", desc_lst, State_Type, Density, NVAR);
 
+  // Velocity gradient, d u_a / dx_d
+  amrex::Vector<std::string> var_names_vel_ders;
+  const std::string vel_names[3] = {"u", "v", "w"};
+  const std::string dir_names[3] = {"x", "y", "z"};
+  for (int a = 0; a < AMREX_SPACEDIM; a++) {
+    for (int d = 0; d < AMREX_SPACEDIM; d++) {
+      var_names_vel_ders.push_back("d" + vel_names[a] + "d" + dir_names[d]);
+    }
+  }
+  derive_lst.add(
+    "vel_ders", amrex::IndexType::TheCellType(),
+    AMREX_SPACEDIM * AMREX_SPACEDIM, var_names_vel_ders, pc_vel_ders,
+    amrex::DeriveRec::GrowBoxByOne);
+  derive_lst.addComponent("vel_ders", desc_lst, State_Type, Density, NVAR);
+
   // Internal energy as derived from rho*E, part of the state
   derive_lst.add(
     "eint_E", amrex::IndexType::TheCellType(), 1, pc_dereint1,
@@ -527,28 +584,45 @@ PeleC::variableSetUp()
   derive_lst.addComponent("magmom", desc_lst, State_Type, Density, NVAR);
 
 
-      // Entropy Inequality
-  int test = NUM_REACTIONS;
-  amrex::Vector<std::string> var_names_EI(9+NUM_SPECIES+test);
-   var_names_EI[0] = "EITerm1";
-   var_names_EI[1] = "EITerm2";
-   var_names_EI[2] = "EITerm3";
-   var_names_EI[3] = "EITerm4";
-   var_names_EI[4] = "EI";
-   var_names_EI[5] = "AUX1";
-   var_names_EI[6] = "AUX2";
-   var_names_EI[7] = "AUX3";
-   var_names_EI[8] = "AUX4";
-   for (int i = 0; i < NUM_SPECIES; i++) {
-    var_names_EI[9+i] = "EI(" + spec_names[i] + ")";
+  // Entropy production rate, by term
+  amrex::Vector<std::string> var_names_entprod(ent_num_comps);
+  var_names_entprod[ent_visc] = "entprod_visc";
+  var_names_entprod[ent_heat] = "entprod_heat";
+  var_names_entprod[ent_diff] = "entprod_diff";
+  var_names_entprod[ent_chem] = "entprod_chem";
+  var_names_entprod[ent_total] = "entprod";
+  derive_lst.add(
+    "entropy_production", amrex::IndexType::TheCellType(), ent_num_comps,
+    var_names_entprod, PeleC::pc_derentropyprod,
+    amrex::DeriveRec::GrowBoxByOne);
+  derive_lst.addComponent(
+    "entropy_production", desc_lst, State_Type, Density, NVAR);
+
+  // Entropy inequality terms, with the chemistry term of each species and
+  // reaction (see EntropyIneqComp)
+  const int nei = ei_spec + NUM_SPECIES + NUM_REACTIONS;
+  amrex::Vector<std::string> var_names_EI(nei);
+  var_names_EI[ei_term1] = "EITerm1";
+  var_names_EI[ei_term2] = "EITerm2";
+  var_names_EI[ei_term3] = "EITerm3";
+  var_names_EI[ei_term4] = "EITerm4";
+  var_names_EI[ei_sum] = "EI";
+  var_names_EI[ei_qx] = "AUX1";
+  var_names_EI[ei_qy] = "AUX2";
+  var_names_EI[ei_qz] = "AUX3";
+  var_names_EI[ei_chem_residual] = "AUX4";
+  for (int i = 0; i < NUM_SPECIES; i++) {
+    var_names_EI[ei_spec + i] = "EI(" + spec_names[i] + ")";
   }
-   for (int i = 0; i < NUM_REACTIONS; i++) {
-     var_names_EI[9+NUM_SPECIES+i] = "EI(Reaction-" + std::to_string(i) + ")";
+  for (int i = 0; i < NUM_REACTIONS; i++) {
+    var_names_EI[ei_spec + NUM_SPECIES + i] =
+      "EI(Reaction-" + std::to_string(i) + ")";
   }
-   derive_lst.add(
-     "entropyInequality", amrex::IndexType::TheCellType(), 9 + NUM_SPECIES + test, var_names_EI,
-     PeleC::pc_entropyInequality, amrex::DeriveRec::GrowBoxByOne);
-   derive_lst.addComponent("entropyInequality", desc_lst, State_Type, Density, NVAR);
+  derive_lst.add(
+    "entropyInequality", amrex::IndexType::TheCellType(), nei, var_names_EI,
+    PeleC::pc_entropyInequality, amrex::DeriveRec::GrowBoxByOne);
+  derive_lst.addComponent(
+    "entropyInequality", desc_lst, State_Type, Density, NVAR);
 
 
 
@@ -719,6 +793,12 @@ PeleC::variableSetUp()
       amrex::Abort("Field " + v + " is not available");
     }
   }
+  for (auto& v : stats_vars) {
+    bool itexists = derive_lst.canDerive(v) || isStateVariable(v, index, scomp);
+    if (!itexists) {
+      amrex::Abort("Statistics field " + v + " is not available");
+    }
+  }
 }
 
 void
@@ -737,6 +817,58 @@ PeleC::variableCleanUp()
   delete h_prob_parm_device;
   amrex::The_Arena()->free(d_prob_parm_device);
   trans_parms.deallocate();
+  free_reaction_stoich();
+  pc_bcfill_clear_cache();
+  pele::pelec::DeltaCheckpoint::clear();
+  pele::pelec::ThermoTable::clear();
+}
+
+void
+PeleC::init_reaction_stoich()
+{
+  const int nreac = NUM_REACTIONS;
+  reac_rmap.assign(nreac, 0);
+  h_reac_nu.assign(static_cast<size_t>(nreac) * NUM_SPECIES, 0.0);
+  if (nreac == 0) {
+    return;
+  }
+
+#if NUM_REACTIONS > 0
+  GET_RMAP(reac_rmap.data());
+  int maxsp = 0;
+  int* none = nullptr;
+  CKINU(0, maxsp, none, none);
+  amrex::Vector<int> ki(maxsp);
+  amrex::Vector<int> nu(maxsp);
+  for (int r = 0; r < nreac; r++) {
+    int nsp = 0;
+    CKINU(reac_rmap[r] + 1, nsp, ki.data(), nu.data());
+    for (int s = 0; s < nsp; s++) {
+      h_reac_nu[r * NUM_SPECIES + ki[s] - 1] += nu[s];
+    }
+  }
+#endif
+
+  d_reac_nu = static_cast<amrex::Real*>(
+    amrex::The_Arena()->alloc(h_reac_nu.size() * sizeof(amrex::Real)));
+  d_reac_rmap =
+    static_cast<int*>(amrex::The_Arena()->alloc(nreac * sizeof(int)));
+  amrex::Gpu::copy(
+    amrex::Gpu::hostToDevice, h_reac_nu.begin(), h_reac_nu.end(), d_reac_nu);
+  amrex::Gpu::copy(
+    amrex::Gpu::hostToDevice, reac_rmap.begin(), reac_rmap.end(),
+    d_reac_rmap);
+}
+
+void
+PeleC::free_reaction_stoich()
+{
+  if (d_reac_nu != nullptr) {
+    amrex::The_Arena()->free(d_reac_nu);
+    amrex::The_Arena()->free(d_reac_rmap);
+    d_reac_nu = nullptr;
+    d_reac_rmap = nullptr;
+  }
 }
 
 void
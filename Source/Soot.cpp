@@ -47,31 +47,33 @@ PeleC::addSootDerivePlotVars(
 void
 PeleC::construct_old_soot_source(amrex::Real time, amrex::Real dt)
 {
-  old_sources[soot_src]->setVal(0.0);
-  if (!add_soot_src) {
-    return;
-  }
-  amrex::MultiFab& S_old = get_old_data(State_Type);
+  amrex::MultiFab& src = old_sources[soot_src]->fill();
+  src.setVal(0.0);
+  if (add_soot_src) {
+    amrex::MultiFab& S_old = get_old_data(State_Type);
 
-  int ng = 0; // None filled
+    int ng = 0; // None filled
 
-  PeleC::fill_soot_source(time, dt, S_old, *old_sources[soot_src], ng);
+    PeleC::fill_soot_source(time, dt, S_old, src, ng);
 
-  old_sources[soot_src]->FillBoundary(geom.periodicity());
+    src.FillBoundary(geom.periodicity());
+  }
+  old_sources[soot_src]->commit();
 }
 
 void
 PeleC::construct_new_soot_source(amrex::Real time, amrex::Real dt)
 {
-  new_sources[soot_src]->setVal(0.0);
-  if (!add_soot_src) {
-    return;
-  }
-  amrex::MultiFab& S_new = get_new_data(State_Type);
+  amrex::MultiFab& src = new_sources[soot_src]->fill();
+  src.setVal(0.0);
+  if (add_soot_src) {
+    amrex::MultiFab& S_new = get_new_data(State_Type);
 
-  int ng = 0;
+    int ng = 0;
 
-  PeleC::fill_soot_source(time, dt, S_new, *new_sources[soot_src], ng);
+    PeleC::fill_soot_source(time, dt, S_new, src, ng);
+  }
+  new_sources[soot_src]->commit();
 }
 
 void
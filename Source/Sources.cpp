@@ -107,7 +107,7 @@ PeleC::sum_of_sources(amrex::MultiFab& source)
   source.setVal(0.0);
 
   for (int n = 0; n < src_list.size(); ++n) {
-    amrex::MultiFab::Add(source, *old_sources[src_list[n]], 0, 0, NVAR, ng);
+    old_sources[src_list[n]]->saxpy(source, 1.0, ng);
   }
 
   if (do_hydro) {
@@ -115,6 +115,6 @@ PeleC::sum_of_sources(amrex::MultiFab& source)
   }
 
   for (int n = 0; n < src_list.size(); ++n) {
-    amrex::MultiFab::Add(source, *new_sources[src_list[n]], 0, 0, NVAR, ng);
+    new_sources[src_list[n]]->saxpy(source, 1.0, ng);
   }
 }
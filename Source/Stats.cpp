@@ -0,0 +1,146 @@
+#include <map>
+
+#include "GradCache.H"
+#include "PeleC.H"
+#include "Stats.H"
+
+// In-situ statistics: time-weighted running means, variances and
+// covariances of user-selected fields, accumulated in Stats_Type state data
+// so that they follow regrids and are written with checkpoints and plotfiles.
+
+void
+PeleC::read_stats_params()
+{
+  stats_vars.clear();
+  stats_corr.clear();
+
+  if (!do_stats) {
+    return;
+  }
+
+  amrex::ParmParse pp("pelec");
+  pp.queryarr("stats_vars", stats_vars);
+
+  amrex::Vector<std::string> corr_names;
+  pp.queryarr("stats_correlations", corr_names);
+
+  auto var_index = [](const std::string& name) {
+    for (int v = 0; v < stats_vars.size(); ++v) {
+      if (stats_vars[v] == name) {
+        return v;
+      }
+    }
+    stats_vars.push_back(name);
+    return static_cast<int>(stats_vars.size()) - 1;
+  };
+
+  // Correlations are given as "a:b", e.g. x_velocity:Temp
+  for (const auto& cn : corr_names) {
+    const auto sep = cn.find(':');
+    if (
+      sep == std::string::npos || sep == 0 || sep == cn.size() - 1 ||
+      cn.find(':', sep + 1) != std::string::npos) {
+      amrex::Abort(
+        "pelec.stats_correlations: expected entries of the form a:b, got " +
+        cn);
+    }
+    const int a = var_index(cn.substr(0, sep));
+    const int b = var_index(cn.substr(sep + 1));
+    stats_corr.push_back(a);
+    stats_corr.push_back(b);
+  }
+
+  if (stats_vars.empty()) {
+    amrex::Abort("pelec.do_stats = 1 requires pelec.stats_vars");
+  }
+  if (stats_interval < 1) {
+    amrex::Abort("pelec.stats_interval must be >= 1");
+  }
+}
+
+amrex::Vector<std::string>
+PeleC::stats_names()
+{
+  const int nvars = static_cast<int>(stats_vars.size());
+  const int ncorr = static_cast<int>(stats_corr.size()) / 2;
+  amrex::Vector<std::string> names(1 + 2 * nvars + ncorr);
+  names[0] = "stats_time";
+  for (int v = 0; v < nvars; ++v) {
+    names[pc_stats_mean_comp(v)] = stats_vars[v] + "_mean";
+    names[pc_stats_var_comp(v)] = stats_vars[v] + "_var";
+  }
+  for (int c = 0; c < ncorr; ++c) {
+    names[pc_stats_cov_comp(nvars, c)] = stats_vars[stats_corr[2 * c]] + "_" +
+                                         stats_vars[stats_corr[2 * c + 1]] +
+                                         "_cov";
+  }
+  return names;
+}
+
+void
+PeleC::update_stats(amrex::Real dt)
+{
+  BL_PROFILE("PeleC::update_stats()");
+
+  // Stats_Type is not swapped in the advance, keep its time in sync
+  const amrex::Real time = state[State_Type].curTime();
+  state[Stats_Type].setNewTimeLevel(time);
+
+  if (time < stats_start_time) {
+    return;
+  }
+  if (parent->levelSteps(level) % stats_interval != 0) {
+    return;
+  }
+
+  const int nvars = static_cast<int>(stats_vars.size());
+  const int ncorr = static_cast<int>(stats_corr.size()) / 2;
+
+  // Gather the sampled fields, deriving each multi-component derive once
+  amrex::MultiFab fields(grids, dmap, nvars, 0, amrex::MFInfo(), Factory());
+  std::map<std::string, std::unique_ptr<amrex::MultiFab>> derived;
+  for (int v = 0; v < nvars; ++v) {
+    int StIndex = 0;
+    int scomp = 0;
+    if (isStateVariable(stats_vars[v], StIndex, scomp)) {
+      amrex::MultiFab::Copy(fields, get_new_data(StIndex), scomp, v, 1, 0);
+    } else {
+      const amrex::DeriveRec* rec = derive_lst.get(stats_vars[v]);
+      auto& mf = derived[rec->name()];
+      if (mf == nullptr) {
+        mf = derive(stats_vars[v], time, 0);
+      }
+      int varIdx = 0;
+      for (int vd = 0; vd < rec->numDerive(); ++vd) {
+        if (stats_vars[v] == rec->variableName(vd)) {
+          varIdx = vd;
+          break;
+        }
+      }
+      amrex::MultiFab::Copy(fields, *mf, varIdx, v, 1, 0);
+    }
+  }
+  derived.clear();
+  pele::pelec::GradientCache::level(level).clear();
+
+  amrex::Gpu::DeviceVector<int> d_corr(stats_corr.size());
+  amrex::Gpu::copy(
+    amrex::Gpu::hostToDevice, stats_corr.begin(), stats_corr.end(),
+    d_corr.begin());
+  const int* corr = d_corr.data();
+
+  // Sample weight is the time elapsed since the previous sample
+  const amrex::Real w = dt * stats_interval;
+
+  amrex::MultiFab& S_stats = get_new_data(Stats_Type);
+  auto const& st = S_stats.arrays();
+  auto const& fld = fields.const_arrays();
+  auto const& vf = vfrac.const_arrays();
+  amrex::ParallelFor(
+    S_stats, [=] AMREX_GPU_DEVICE(int nbx, int i, int j, int k) noexcept {
+      if (vf[nbx](i, j, k) > 0.0) {
+        pc_stats_update(i, j, k, fld[nbx], st[nbx], nvars, ncorr, corr, w);
+      }
+    });
+  amrex::Gpu::synchronize();
+}
@@ -1,6 +1,7 @@
 #include <iomanip>
 
 #include "PeleC.H"
+#include "EntropyProd.H"
 
 void
 PeleC::sum_integrated_quantities()
@@ -269,3 +270,191 @@ PeleC::monitor_extrema()
     }
   }
 }
+
+void
+PeleC::sum_entropy_budget()
+{
+  BL_PROFILE("PeleC::sum_entropy_budget()");
+
+  if (verbose <= 0) {
+    return;
+  }
+
+#if NUM_SPECIES > 1
+  const int finest_level = parent->finestLevel();
+  const amrex::Real time = state[State_Type].curTime();
+
+  // Net stoichiometric coefficients in the internal reaction order
+  const int nreac = NUM_REACTIONS;
+  const amrex::Vector<int>& rmap = reac_rmap;
+  const amrex::Real* nu_ptr = d_reac_nu;
+
+  // Volume integrals of the terms, volume and number of cells where the
+  // total is negative, then the integral of each reaction's contribution.
+  // These are the entropy production terms, in erg/cm^3/s/K, rather than the
+  // entropyInequality ones, which are the same terms times minus the
+  // temperature and would not add up to the entropy produced in the domain.
+  const int ivol = ent_num_comps;
+  const int icnt = ivol + 1;
+  const int ireac = icnt + 1;
+  const int nsum = ireac + nreac;
+  amrex::Vector<amrex::Real> h_sums(nsum, 0.0);
+  static_assert(ent_num_comps == 5, "ent_num_comps changed");
+
+  auto const* ltransparm = trans_parms.device_trans_parm();
+  const auto thermo = pele::pelec::ThermoTable::view();
+  const int terms = (1 << ent_visc) | (1 << ent_heat) | (1 << ent_diff) |
+                    (1 << ent_chem);
+
+  for (int lev = 0; lev <= finest_level; lev++) {
+    PeleC& pc_lev = getLevel(lev);
+
+    amrex::MultiFab S(
+      pc_lev.grids, pc_lev.dmap, NVAR, 1, amrex::MFInfo(), pc_lev.Factory());
+    FillPatch(pc_lev, S, S.nGrow(), time, State_Type, Density, NVAR, 0);
+
+    amrex::MultiFab ones;
+    if (lev == finest_level) {
+      ones.define(pc_lev.grids, pc_lev.dmap, 1, 0);
+      ones.setVal(1.0);
+    }
+    const amrex::MultiFab& mask =
+      (lev < finest_level) ? getLevel(lev + 1).build_fine_mask() : ones;
+
+    const auto& ebfact =
+      dynamic_cast<amrex::EBFArrayBoxFactory const&>(pc_lev.Factory());
+    auto const& flag_arrs = ebfact.getMultiEBCellFlagFab().const_arrays();
+    auto const& s_arrs = S.const_arrays();
+    auto const& vfrac_arrs = pc_lev.vfrac.const_arrays();
+    auto const& mask_arrs = mask.const_arrays();
+    const auto dxinv = pc_lev.geom.InvCellSizeArray();
+    amrex::Real dv = 1.0;
+    for (int dir = 0; dir < AMREX_SPACEDIM; dir++) {
+      dv *= pc_lev.geom.CellSize(dir);
+    }
+
+    // All the term integrals in a single pass over the cells
+    using Sum = amrex::ReduceOpSum;
+    using R = amrex::Real;
+    const auto r = amrex::ParReduce(
+      amrex::TypeList<Sum, Sum, Sum, Sum, Sum, Sum, Sum>{},
+      amrex::TypeList<R, R, R, R, R, R, R>{}, S, amrex::IntVect(0),
+      [=] AMREX_GPU_DEVICE(int nbx, int i, int j, int k) noexcept
+      -> amrex::GpuTuple<R, R, R, R, R, R, R> {
+        const amrex::Real wgt =
+          dv * vfrac_arrs[nbx](i, j, k) * mask_arrs[nbx](i, j, k);
+        if (wgt <= 0.0) {
+          return {0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
+        }
+        amrex::Real sig[ent_num_comps];
+        pc_entropy_production(
+          i, j, k, s_arrs[nbx], flag_arrs[nbx], false, dxinv, terms,
+          ltransparm, thermo, sig);
+        const amrex::Real neg = (sig[ent_total] < 0.0) ? 1.0 : 0.0;
+        return {wgt * sig[ent_visc], wgt * sig[ent_heat], wgt * sig[ent_diff],
+                wgt * sig[ent_chem], wgt * sig[ent_total], wgt * neg, neg};
+      });
+    h_sums[ent_visc] += amrex::get<0>(r);
+    h_sums[ent_heat] += amrex::get<1>(r);
+    h_sums[ent_diff] += amrex::get<2>(r);
+    h_sums[ent_chem] += amrex::get<3>(r);
+    h_sums[ent_total] += amrex::get<4>(r);
+    h_sums[ivol] += amrex::get<5>(r);
+    h_sums[icnt] += amrex::get<6>(r);
+
+#if NUM_REACTIONS > 0
+    // The per-reaction contributions are weighted into a temporary and
+    // summed component by component
+    amrex::MultiFab S_reac(pc_lev.grids, pc_lev.dmap, nreac, 0);
+    auto const& r_arrs = S_reac.arrays();
+    amrex::ParallelFor(
+      S_reac, [=] AMREX_GPU_DEVICE(int nbx, int i, int j, int k) noexcept {
+        const amrex::Real wgt =
+          dv * vfrac_arrs[nbx](i, j, k) * mask_arrs[nbx](i, j, k);
+        auto const& sr = r_arrs[nbx];
+        if (wgt <= 0.0) {
+          for (int n = 0; n < NUM_REACTIONS; n++) {
+            sr(i, j, k, n) = 0.0;
+          }
+          return;
+        }
+        amrex::Real sig_r[NUM_REACTIONS];
+        pc_entropy_production_reactions(
+          i, j, k, s_arrs[nbx], nu_ptr, thermo, sig_r);
+        for (int n = 0; n < NUM_REACTIONS; n++) {
+          sr(i, j, k, n) = wgt * sig_r[n];
+        }
+      });
+    amrex::Gpu::streamSynchronize();
+    for (int n = 0; n < nreac; n++) {
+      h_sums[ireac + n] += S_reac.sum(n, true);
+    }
+#else
+    amrex::ignore_unused(nu_ptr);
+#endif
+  }
+
+  amrex::ParallelDescriptor::ReduceRealSum(
+    h_sums.data(), nsum, amrex::ParallelDescriptor::IOProcessorNumber());
+
+  if (amrex::ParallelDescriptor::IOProcessor()) {
+    // Per-reaction integrals back in the original reaction order
+    amrex::Vector<amrex::Real> reac(nreac);
+    for (int r = 0; r < nreac; r++) {
+      reac[rmap[r]] = h_sums[ireac + r];
+    }
+
+    amrex::Print() << '\n';
+    amrex::Print() << "TIME = " << time << " EI VISC     = " << h_sums[ent_visc]
+                   << '\n';
+    amrex::Print() << "TIME = " << time << " EI HEAT     = " << h_sums[ent_heat]
+                   << '\n';
+    amrex::Print() << "TIME = " << time << " EI DIFF     = " << h_sums[ent_diff]
+                   << '\n';
+    amrex::Print() << "TIME = " << time << " EI CHEM     = " << h_sums[ent_chem]
+                   << '\n';
+    amrex::Print() << "TIME = " << time
+                   << " EI TOTAL    = " << h_sums[ent_total] << '\n';
+    amrex::Print() << "TIME = " << time << " EI < 0 VOL  = " << h_sums[ivol]
+                   << " (" << static_cast<amrex::Long>(h_sums[icnt])
+                   << " cells)" << '\n';
+
+    const int log_index = find_datalog_index("entropylog");
+    if (log_index >= 0) {
+      std::ostream& data_log1 = parent->DataLog(log_index);
+      if (data_log1.good()) {
+        const int datwidth = 18;
+        if (time == 0.0) {
+          data_log1 << std::setw(datwidth) << "time";
+          data_log1 << std::setw(datwidth) << "EI_visc";
+          data_log1 << std::setw(datwidth) << "EI_heat";
+          data_log1 << std::setw(datwidth) << "EI_diff";
+          data_log1 << std::setw(datwidth) << "EI_chem";
+          data_log1 << std::setw(datwidth) << "EI_total";
+          data_log1 << std::setw(datwidth) << "viol_volume";
+          data_log1 << std::setw(datwidth) << "viol_cells";
+          for (int r = 0; r < nreac; r++) {
+            data_log1 << std::setw(datwidth) << "EI_R" + std::to_string(r);
+          }
+          data_log1 << std::endl;
+        }
+
+        // Write the quantities at this time
+        const int datprecision = 10;
+        data_log1 << std::setw(datwidth) << time;
+        for (int n = 0; n < icnt; n++) {
+          data_log1 << std::setw(datwidth) << std::setprecision(datprecision)
+                    << h_sums[n];
+        }
+        data_log1 << std::setw(datwidth)
+                  << static_cast<amrex::Long>(h_sums[icnt]);
+        for (int r = 0; r < nreac; r++) {
+          data_log1 << std::setw(datwidth) << std::setprecision(datprecision)
+                    << reac[r];
+        }
+        data_log1 << std::endl;
+      }
+    }
+  }
+#endif
+}
@@ -44,6 +44,61 @@ PeleC::read_tagging_params()
   pp.query("vfracerr", tagging_parm->vfracerr);
   pp.query("max_vfracerr_lev", tagging_parm->max_vfracerr_lev);
 
+  // Entropy production, only evaluated when one of its criteria is given
+  tagging_parm->do_entropyerr_tag =
+    pp.query("entropyerr", tagging_parm->entropyerr) != 0;
+  pp.query("max_entropyerr_lev", tagging_parm->max_entropyerr_lev);
+  tagging_parm->do_entropygrad_tag =
+    pp.query("entropygrad", tagging_parm->entropygrad) != 0;
+  pp.query("max_entropygrad_lev", tagging_parm->max_entropygrad_lev);
+  tagging_parm->do_entropy_term_tag[ent_visc] =
+    pp.query("entropy_visc_err", tagging_parm->entropy_visc_err) != 0;
+  pp.query("max_entropy_visc_err_lev", tagging_parm->max_entropy_visc_err_lev);
+  tagging_parm->do_entropy_term_tag[ent_heat] =
+    pp.query("entropy_heat_err", tagging_parm->entropy_heat_err) != 0;
+  pp.query("max_entropy_heat_err_lev", tagging_parm->max_entropy_heat_err_lev);
+  tagging_parm->do_entropy_term_tag[ent_diff] =
+    pp.query("entropy_diff_err", tagging_parm->entropy_diff_err) != 0;
+  pp.query("max_entropy_diff_err_lev", tagging_parm->max_entropy_diff_err_lev);
+  tagging_parm->do_entropy_term_tag[ent_chem] =
+    pp.query("entropy_chem_err", tagging_parm->entropy_chem_err) != 0;
+  pp.query("max_entropy_chem_err_lev", tagging_parm->max_entropy_chem_err_lev);
+  bool found =
+    tagging_parm->do_entropyerr_tag || tagging_parm->do_entropygrad_tag;
+  for (int t = 0; t < ent_total; t++) {
+    found = found || tagging_parm->do_entropy_term_tag[t];
+  }
+  tagging_parm->do_entropy_tag = found;
+
+  const int nterms = pp.countval("entropy_terms");
+  if (nterms > 0) {
+    amrex::Vector<std::string> terms;
+    pp.getarr("entropy_terms", terms, 0, nterms);
+    tagging_parm->entropy_terms = 0;
+    for (const auto& term : terms) {
+      if (term == "visc") {
+        tagging_parm->entropy_terms |= (1 << ent_visc);
+      } else if (term == "heat") {
+        tagging_parm->entropy_terms |= (1 << ent_heat);
+      } else if (term == "diff") {
+        tagging_parm->entropy_terms |= (1 << ent_diff);
+      } else if (term == "chem") {
+        tagging_parm->entropy_terms |= (1 << ent_chem);
+      } else {
+        amrex::Abort(
+          "tagging.entropy_terms can only contain visc, heat, diff or chem");
+      }
+    }
+  }
+  const int requested = (nvisc > 0 ? (1 << ent_visc) : 0) |
+                        (nheat > 0 ? (1 << ent_heat) : 0) |
+                        (ndiff > 0 ? (1 << ent_diff) : 0) |
+                        (nchem > 0 ? (1 << ent_chem) : 0);
+  if ((requested & ~tagging_parm->entropy_terms) != 0) {
+    amrex::Abort("Entropy term criterion given for a term not in "
+                 "tagging.entropy_terms");
+  }
+
   pp.query("eb_refine_type", tagging_parm->eb_refine_type);
   pp.query("max_eb_refine_lev", tagging_parm->max_eb_refine_lev);
   pp.query("eb_detag_factor", tagging_parm->detag_eb_factor);
@@ -0,0 +1,152 @@
+#include <cmath>
+#include <limits>
+#include <string>
+
+#include <AMReX_Arena.H>
+#include <AMReX_GpuContainers.H>
+#include <AMReX_ParallelDescriptor.H>
+#include <AMReX_Print.H>
+#include <AMReX_Vector.H>
+
+#include "ThermoTable.H"
+
+namespace pele::pelec {
+
+ThermoTableView ThermoTable::s_view;
+amrex::Real* ThermoTable::s_data = nullptr;
+
+namespace {
+void
+thermo_eval(
+  const ThermoTableView& tv,
+  const int comp,
+  const amrex::Real T,
+  amrex::Real out[NUM_SPECIES])
+{
+  if (comp == thermo_h) {
+    tv.T2Hi(T, out);
+  } else if (comp == thermo_cp) {
+    tv.T2Cpi(T, out);
+  } else {
+    tv.T2Gi_RT(T, out);
+  }
+}
+
+// All the components at the midpoints of the nodes of tv, evaluated with
+// eval into vals. Returns the time taken.
+amrex::Real
+thermo_sweep(
+  const ThermoTableView& tv,
+  const ThermoTableView& eval,
+  amrex::Vector<amrex::Real>& vals)
+{
+  constexpr int stride = thermo_ncomp * NUM_SPECIES;
+  vals.resize(static_cast<size_t>(tv.nnodes - 1) * stride);
+  const amrex::Real dT = 1.0 / tv.dTinv;
+  const amrex::Real t0 = amrex::ParallelDescriptor::second();
+  for (int node = 0; node < tv.nnodes - 1; node++) {
+    const amrex::Real T = tv.Tmin + (node + 0.5) * dT;
+    for (int comp = 0; comp < thermo_ncomp; comp++) {
+      thermo_eval(eval, comp, T, &vals[node * stride + comp * NUM_SPECIES]);
+    }
+  }
+  return amrex::ParallelDescriptor::second() - t0;
+}
+} // namespace
+
+void
+ThermoTable::build(
+  amrex::Real Tmin,
+  amrex::Real Tmax,
+  amrex::Real dT,
+  amrex::Real tol,
+  bool verbose)
+{
+  BL_PROFILE("ThermoTable::build()");
+  clear();
+  if ((dT <= 0.0) || (Tmax <= Tmin)) {
+    amrex::Abort("ThermoTable: thermo_table_Tmax > Tmin and dT > 0 needed");
+  }
+  const int nnodes = static_cast<int>(std::floor((Tmax - Tmin) / dT)) + 1;
+  if (nnodes < 4) {
+    amrex::Abort("ThermoTable: at least 4 temperatures are needed");
+  }
+
+  // Tabulate with the polynomials
+  constexpr int stride = thermo_ncomp * NUM_SPECIES;
+  const ThermoTableView poly;
+  amrex::Vector<amrex::Real> h_data(static_cast<size_t>(nnodes) * stride);
+  amrex::Real scale[stride] = {0.0};
+  for (int node = 0; node < nnodes; node++) {
+    const amrex::Real T = Tmin + node * dT;
+    amrex::Real* row = &h_data[static_cast<size_t>(node) * stride];
+    for (int comp = 0; comp < thermo_ncomp; comp++) {
+      thermo_eval(poly, comp, T, row + comp * NUM_SPECIES);
+    }
+    for (int n = 0; n < stride; n++) {
+      scale[n] = amrex::max(scale[n], std::abs(row[n]));
+    }
+  }
+
+  ThermoTableView tv;
+  tv.data = h_data.data();
+  tv.Tmin = Tmin;
+  tv.Tmax = Tmin + (nnodes - 1) * dT;
+  tv.dTinv = 1.0 / dT;
+  tv.nnodes = nnodes;
+
+  // Accuracy (and speed) of the interpolation against the polynomials
+  amrex::Vector<amrex::Real> vpoly;
+  amrex::Vector<amrex::Real> vtab;
+  const amrex::Real tpoly = thermo_sweep(tv, poly, vpoly);
+  const amrex::Real ttab = thermo_sweep(tv, tv, vtab);
+  // The Gibbs energies are tabulated over RT, so that their error is
+  // relative to RT at each temperature, which is what the equilibrium
+  // constants exp(-g/RT) see. The largest magnitude over the table would
+  // hide the errors at high temperatures, where g/RT is small.
+  amrex::Real err[thermo_ncomp] = {0.0};
+  for (size_t m = 0; m < vpoly.size(); m++) {
+    const int n = static_cast<int>(m % stride);
+    const amrex::Real s =
+      (n / NUM_SPECIES == thermo_g)
+        ? 1.0
+        : amrex::max(scale[n], std::numeric_limits<amrex::Real>::min());
+    err[n / NUM_SPECIES] =
+      amrex::max(err[n / NUM_SPECIES], std::abs(vtab[m] - vpoly[m]) / s);
+  }
+
+  if (verbose) {
+    amrex::Print() << "ThermoTable: " << nnodes << " temperatures in ["
+                   << tv.Tmin << ", " << tv.Tmax << "] K, largest relative "
+                   << "errors h " << err[thermo_h] << ", cp "
+                   << err[thermo_cp] << ", g " << err[thermo_g]
+                   << ", lookups " << tpoly / amrex::max(ttab, 1.0e-12)
+                   << "x as fast as the polynomials" << std::endl;
+  }
+  for (const amrex::Real e : err) {
+    if (e > tol) {
+      amrex::Abort(
+        "ThermoTable: interpolation error " + std::to_string(e) +
+        " above pelec.thermo_table_tol, decrease pelec.thermo_table_dT");
+    }
+  }
+
+  s_data = static_cast<amrex::Real*>(
+    amrex::The_Arena()->alloc(h_data.size() * sizeof(amrex::Real)));
+  amrex::Gpu::copy(
+    amrex::Gpu::hostToDevice, h_data.begin(), h_data.end(), s_data);
+  s_view = tv;
+  s_view.data = s_data;
+}
+
+void
+ThermoTable::clear()
+{
+  if (s_data != nullptr) {
+    amrex::The_Arena()->free(s_data);
+    s_data = nullptr;
+  }
+  s_view = ThermoTableView{};
+}
+
+} // namespace pele::pelec
@@ -23,8 +23,15 @@ read_binary(
     amrex::Abort("Unable to open input file " + iname);
   }
 
-  for (size_t i = 0; i < nx * ny * nz * ncol; i++) {
-    infile.read(reinterpret_cast<char*>(&data[i]), sizeof(data[i]));
+  // One bulk read, see pele::pelec::BlockReader to read only a sub-block
+  data.resize(nx * ny * nz * ncol);
+  infile.read(
+    reinterpret_cast<char*>(data.data()),
+    static_cast<std::streamsize>(data.size() * sizeof(double)));
+  if (!infile) {
+    amrex::Abort(
+      "Unable to read " + std::to_string(data.size()) +
+      " doubles from input file " + iname);
   }
   infile.close();
 }
@@ -150,3 +157,139 @@ clean_massfrac(
       }
     });
 }
+
+void
+pc_cmpTemp_newton_rows(
+  const amrex::Box& bx,
+  amrex::Array4<amrex::Real> const& S,
+  amrex::Array4<const amrex::EBCellFlag> const& flags,
+  const amrex::Real tol,
+  const int maxiter,
+  amrex::Long& iters,
+  amrex::Long& cells)
+{
+  constexpr int nl = temp_newton_lanes;
+  constexpr int unused = 0;
+  constexpr int iterating = 1;
+  constexpr int converged = 2;
+  constexpr int failed = 3;
+  auto eos = pele::physics::PhysicsType::eos();
+  amrex::Real imw[NUM_SPECIES];
+  eos.inv_molecular_weight(imw);
+  const auto lo = amrex::lbound(bx);
+  const auto hi = amrex::ubound(bx);
+
+  // Mass fractions, species enthalpies and heat capacities (species-major,
+  // lanes innermost), energy, gas constant, initial and current temperature
+  // of each lane
+  amrex::Real Y[NUM_SPECIES][nl];
+  amrex::Real hk[NUM_SPECIES][nl];
+  amrex::Real cpk[NUM_SPECIES][nl];
+  amrex::Real e[nl];
+  amrex::Real R[nl];
+  amrex::Real T0[nl];
+  amrex::Real T[nl];
+  amrex::Real h[nl];
+  amrex::Real cp[nl];
+  int status[nl];
+  int it[nl];
+  amrex::Real hrow[NUM_SPECIES];
+  amrex::Real cprow[NUM_SPECIES];
+  amrex::Real massfrac[NUM_SPECIES];
+
+  for (int k = lo.z; k <= hi.z; ++k) {
+    for (int j = lo.y; j <= hi.y; ++j) {
+      for (int i0 = lo.x; i0 <= hi.x; i0 += nl) {
+        const int nlanes = amrex::min(nl, hi.x - i0 + 1);
+        // Lanes that do not iterate hold finite values, so that the masked
+        // update of all the lanes does not divide by zero
+        for (int n = 0; n < NUM_SPECIES; ++n) {
+          for (int l = 0; l < nl; ++l) {
+            Y[n][l] = (n == 0) ? 1.0 : 0.0;
+            hk[n][l] = 0.0;
+            cpk[n][l] = 1.0;
+          }
+        }
+        for (int l = 0; l < nl; ++l) {
+          status[l] = unused;
+          it[l] = 0;
+          e[l] = 0.0;
+          R[l] = 0.0;
+          T0[l] = 1.0;
+          T[l] = 1.0;
+          if ((l >= nlanes) || flags(i0 + l, j, k).isCovered()) {
+            continue;
+          }
+          const amrex::Real rhoInv = 1.0 / S(i0 + l, j, k, URHO);
+          e[l] = S(i0 + l, j, k, UEINT) * rhoInv;
+          for (int n = 0; n < NUM_SPECIES; ++n) {
+            Y[n][l] = S(i0 + l, j, k, UFS + n) * rhoInv;
+            R[l] += Y[n][l] * imw[n];
+          }
+          R[l] *= pele::physics::Constants::RU;
+          T0[l] = S(i0 + l, j, k, UTEMP);
+          T[l] = T0[l];
+          status[l] = (T[l] > 0.0) ? iterating : failed;
+        }
+
+        // Iterate the lanes together until they all exit. The species
+        // thermodynamics are evaluated lane by lane, the mixture sums and
+        // the update over all the lanes, keeping those that have exited.
+        for (int iter = 0; iter < maxiter; ++iter) {
+          bool any = false;
+          for (int l = 0; l < nl; ++l) {
+            if (status[l] == iterating) {
+              eos.T2Hi(T[l], hrow);
+              CKCPMS(T[l], cprow);
+              for (int n = 0; n < NUM_SPECIES; ++n) {
+                hk[n][l] = hrow[n];
+                cpk[n][l] = cprow[n];
+              }
+              any = true;
+            }
+          }
+          if (!any) {
+            break;
+          }
+          for (int l = 0; l < nl; ++l) {
+            h[l] = 0.0;
+            cp[l] = 0.0;
+          }
+          for (int n = 0; n < NUM_SPECIES; ++n) {
+            for (int l = 0; l < nl; ++l) {
+              h[l] += Y[n][l] * hk[n][l];
+              cp[l] += Y[n][l] * cpk[n][l];
+            }
+          }
+          for (int l = 0; l < nl; ++l) {
+            const bool active = status[l] == iterating;
+            amrex::Real Tl = T[l];
+            const bool done =
+              pc_temp_newton_update(e[l], R[l], h[l], cp[l], tol, Tl);
+            const int next =
+              done ? converged : ((Tl > 0.0) ? iterating : failed);
+            T[l] = active ? Tl : T[l];
+            it[l] += active ? 1 : 0;
+            status[l] = active ? next : status[l];
+          }
+        }
+
+        for (int l = 0; l < nlanes; ++l) {
+          if (status[l] == unused) {
+            continue;
+          }
+          if (status[l] != converged) {
+            for (int n = 0; n < NUM_SPECIES; ++n) {
+              massfrac[n] = Y[n][l];
+            }
+            T[l] = T0[l];
+            eos.REY2T(S(i0 + l, j, k, URHO), e[l], massfrac, T[l]);
+          }
+          S(i0 + l, j, k, UTEMP) = T[l];
+          iters += it[l];
+          cells++;
+        }
+      }
+    }
+  }
+}